@@ -2,6 +2,8 @@
 //#include "Adafruit_VL53L0X.h"
 #include "Wire.h"
 #include "VL53L0X.h"
+#include <EEPROM.h>
+#include <avr/sleep.h>
 
 // Macros
 #define serialWriteSuccessOrFail(result) {\
@@ -14,10 +16,10 @@
 #define txPin 0
 
     // ENCODER
-// #define encoder_master_pinA 4   //master encoder A pin -> the digital pin 3
-// #define encoder_master_pinB 2   //master encoder B pin -> the interrupt pin 0
-// #define encoder_slave_pinB 3    //B pin -> the interrupt pin 1
-// #define encoder_slave_pinA 7    //A pin -> the digital pin 5
+#define encoder_master_pinA 4   //master encoder A pin -> the digital pin 4
+#define encoder_master_pinB 2   //master encoder B pin -> the interrupt pin 0
+#define encoder_slave_pinB 3    //B pin -> the interrupt pin 1
+#define encoder_slave_pinA 7    //A pin -> the digital pin 7
 
     // MOTORS
 #define leftmotor_pinA 5
@@ -26,12 +28,13 @@
 #define rightmotor_pinB 11
 
     // SENSOR
-// #define XSHUT_sensor_base 2
-// #define XSHUT_sensor_tire1 3
-// #define XSHUT_sensor_tire2 4
+#define XSHUT_sensor_base A1     // Digital pins 2-4 are taken by the encoders
+#define XSHUT_sensor_tire1 A2
+#define XSHUT_sensor_tire2 A3
 
     // OTHER
 #define pole_detected_signal_pin 8
+#define sensor_base_gpio1_pin 12    // VL53L0X GPIO1 (new sample ready, active low until cleared)
 
 // I2C Addresses
 #define Sensor_Base_Addr 0x29     // Default address of the sensor is 0x29 (41)
@@ -49,17 +52,105 @@
 #define PS_None 3
 
 #define POLE_DETECTED_RANGE 240         // Maximium distance a pole can be detected
+#define POLE_CLEARED_RANGE 270          // Distance beyond which a detected pole has left the sensor's view
+#define POLE_MEDIAN_WINDOW 5            // Number of readings the pole detector takes the median of (odd)
 #define TIRE_DETECTED_RANGE 210         // Maximum distance a tire can be detected
-#define VALID_VERIFICATION_COUNT 1     // How many times the sensor should detect the pole
-#define POLE_DETECTED_BUFFER_REGION 100 // How much distance it must travel before it can detect a new pole
+#define MIN_POLE_SPACING_MM 100         // Closest two poles can be (the robot cruises until then)
 #define FIRST_POLE_MIN_DISTANCE_MM 100  // The minimum distance the first pole will be found 
 #define MAX_POLES 10                    // Maximum number of poles in the operation
+#define NO_POLE 0xFF                    // Pole index that matches no pole
+#define ISOLATED_POLE_SPACING_MM 300    // Poles at least this far past the previous pole require 2 tires
 #define MAX_DISTANCE_MM 4000            // Maximum distance the robot should travel for the operation
 
 #define OPTIMAL_MIN_RANGE 115
 #define OPTIMAL_MAX_RANGE 119
-#define DRIVESPEED_MM_PER_SECOND 190
+#define OPTIMAL_RANGE ((OPTIMAL_MIN_RANGE + OPTIMAL_MAX_RANGE) / 2)
+
+#define CRUISE_DUTY 130                 // Duty while no pole can be detected (between poles)
+#define RETURN_DUTY 255                 // Duty while returning to the start (full speed)
+#define APPROACH_DUTY 170               // Duty while driving back to a mapped pole
+#define CRUISE_BRAKING_MM 30            // Distance before the search region where cruising stops
+#define RETURN_SLOWDOWN_MM 150          // Distance from the start where returning slows to the search duty
+#define MAPPING_DUTY 170                // Duty while mapping the poles (detection only)
+#define APPROACH_SLOWDOWN_MM 150        // Distance from a mapped pole where approaching slows to the search duty
+
+#define OP_MODE_SINGLE_PASS 0           // Deploy at each pole as it is found on the way out
+#define OP_MODE_TWO_PASS 1              // Map every pole on the way out, then deploy on the way back
+
+#define TRIM_EEPROM_ADDR 0              // EEPROM address of the stored motor trim
+#define TRIM_EEPROM_MAGIC 0xA5          // Marks a valid trim in EEPROM
+#define TRIM_CALIBRATION_DISTANCE_MM 1000   // Length of the reference run used to fit the trim
+#define TRIM_MIN_SAMPLES 10             // Minimum valid lateral readings needed to fit the trim
+#define TRIM_REFERENCE_RANGE 400        // Lateral readings further than this are not the reference wall
+#define TRIM_DUTY_PER_SLOPE 400         // Right motor duty change per mm/mm of lateral drift (positive: drifting away from the sensor side)
+#define ONLINE_TRIM_CORRECTION true     // Correct the trim from the wheel encoders while driving
+#define ONLINE_TRIM_GAIN_Q4 8           // Right motor duty per tick of left/right difference (4 fractional bits)
+#define ONLINE_TRIM_MAX 20              // Largest online correction applied to the right motor duty
+
+#define SERIAL_TASK_INTERVAL_MS 1       // How often messages from the PIC are serviced
+#define SENSOR_TASK_INTERVAL_MS 0       // The base sensor data-ready line is checked on every pass
+#define SENSOR_TIMEOUT_MS 500           // Time without a new reading before a sensor timeout is reported
+#define SERIAL_READ_TIMEOUT_MS 100      // Time to wait for the rest of a message from the PIC (a byte takes 1 ms)
+#define SAMPLE_BUFFER_SIZE 8            // Number of unconsumed sensor readings that can be buffered
+#define ODOMETRY_TASK_INTERVAL_MS 5     // How often the position is updated from the encoders
+#define STATE_TASK_INTERVAL_MS 5        // How often the state machine runs
+#define POLE_SETTLE_MS 100              // Time to let the robot settle after stopping at a pole
+
+// Run the alignment loop on the Arduino rather than through the PIC. Off: the Arduino's drive wheels move the
+// robot along the course, and only the PIC's omni wheels move it towards or away from the pole
+#define ALIGN_ON_ARDUINO false
+#define ALIGN_TOWARDS MOTORSTATE_FORWARD    // Drive direction that brings the sensor closer to the pole
+#define ALIGN_AWAY MOTORSTATE_BACKWARD      // Drive direction that moves the sensor away from the pole
+#define ALIGN_GAIN 4                    // PWM duty per millimetre of alignment error
+#define ALIGN_MIN_DUTY 35               // Lowest duty that still moves the robot
+#define ALIGN_MAX_DUTY 72               // Highest duty used while aligning
+#define ALIGN_SETTLE_COUNT 3            // Consecutive readings in the optimal range required to be aligned
+#define ALIGN_TIMEOUT_MS 3000           // Deploy where the robot is, and report the misalignment, if alignment takes longer
+#define PIPELINED_DEPLOYMENT true       // Have the PIC push the tire up to its drop point while aligning
+#define FAST_TIMING_BUDGET_US 20000    // Sensor timing budget while cruising and searching (shortest the VL53L0X allows)
+#define FAST_AVERAGING_SAMPLES 1        // Readings averaged per decision with the fast profile
+#define ACCURATE_TIMING_BUDGET_US 100000    // Sensor timing budget while aligning (lower ranging noise)
+#define ACCURATE_AVERAGING_SAMPLES 3    // Readings averaged per decision with the accurate profile
+#define SENSOR_AVERAGE_WINDOW_MAX 8     // Largest number of readings a sensor profile can average
+#define SENSOR_EMA_SHIFT 2              // Weight of each new reading in the exponential average (1 / 2^shift)
+#define TIRE_SENSOR_COUNT 2             // Number of sensors looking for tires on a pole
+#define TIRE_SENSOR_TIMING_BUDGET_US FAST_TIMING_BUDGET_US  // Tire sensors always range with the short budget
+#define TIRE_SENSOR_TASK_INTERVAL_MS 5  // How often the next tire sensor is polled for a reading
+#define MM_PER_TICK_Q8 181              // Distance travelled per master encoder tick (mm, 8.8 fixed point, nominal: re-measure over a known distance)
 // Structs
+typedef struct {
+    unsigned short distance;    // Measured distance (mm)
+    unsigned long time;         // Time (ms) the reading became available
+    unsigned short position;    // Position (mm) of the robot when the reading became available
+} SensorSample;
+
+typedef struct {
+    unsigned short distance[POLE_MEDIAN_WINDOW];    // Most recent readings of the base sensor
+    unsigned short position[POLE_MEDIAN_WINDOW];    // Position (mm) of each of the readings
+    byte head;                  // Index the next reading is stored at
+    byte count;                 // Number of readings in the window
+    bool inView;                // Whether a pole is currently in front of the sensor
+    unsigned short entryPosition;   // Position (mm) the current pole came into view
+    unsigned short exitPosition;    // Position (mm) the last pole left the view
+} PoleDetector;
+
+typedef enum {
+    POLE_EVENT_NONE,
+    POLE_EVENT_ENTERED,
+    POLE_EVENT_EXITED
+} PoleEvent;
+
+typedef struct {
+    unsigned long timingBudgetUs;   // Time the sensor spends on each reading
+    byte averagingSamples;          // Readings averaged before the reading is acted on
+} SensorProfile;
+
+typedef struct {
+    void (*run)(void);          // Function performing the task
+    unsigned long intervalMs;   // Time between runs of the task
+    unsigned long lastRun;      // Time (ms) the task last ran
+} Task;
+
 typedef struct {
      byte totalSuppliedTires;
      byte totalNumberOfPoles;
@@ -78,7 +169,7 @@ const Operation emptyOp = { .totalSuppliedTires = 0,
                             .tiresDeployedOnPole = {},
                             .tiresOnPoleAfterOperation = {},
                             .distanceOfPole = {},
-                            .tiresRemaining = 5,
+                            .tiresRemaining = 0,
                             .position_in_mm = 0
                             };
 
@@ -90,7 +181,10 @@ typedef enum {
     POLE_DETECTED,
     ADJUSTING,
     RETURNING,
-    COMPLETE
+    COMPLETE,
+    CALIBRATING,
+    MAPPING,
+    APPROACHING
 } STATE;
 
 typedef enum {
@@ -111,6 +205,8 @@ typedef enum {
     MSG_P2A_REQUEST_INITIALIZE_SENSOR,
     MSG_P2A_REQUEST_STATUS_SENSORS,
     MSG_P2A_ADJUSTMENT_COMPLETE,
+    MSG_P2A_CALIBRATE_TRIM,
+    MSG_P2A_PROBE_DUMP,
     
     // Arduino to PIC Messages
     MSG_A2P_SUCCESS = 100,
@@ -123,6 +219,11 @@ typedef enum {
     MSG_A2P_SENSOR_TIMEOUT,
     MSG_A2P_ADJUST_TOWARDS,
     MSG_A2P_ADJUST_AWAY,
+    MSG_A2P_ALIGNED,
+    MSG_A2P_MAPPING,
+    MSG_A2P_PREPARE_DEPLOY,
+    MSG_A2P_UART_READ_TIMEOUT,
+    MSG_A2P_ALIGN_TIMEOUT,
 
 } MSG_CODE;
 
@@ -132,6 +233,7 @@ typedef enum {
 // byte rightmotor_speed = 70;
 byte leftmotor_speed = 72;
 byte rightmotor_speed = 81;
+int trimCorrection = 0;     // Online correction added to the right motor duty while driving forward
 bool debugMode = false;
 
 // Setup objects
@@ -140,6 +242,16 @@ VL53L0X Sensor_Base;
 VL53L0X Sensor_Tire1;
 VL53L0X Sensor_Tire2;
 
+const SensorProfile fastSensorProfile = { FAST_TIMING_BUDGET_US, FAST_AVERAGING_SAMPLES };
+const SensorProfile accurateSensorProfile = { ACCURATE_TIMING_BUDGET_US, ACCURATE_AVERAGING_SAMPLES };
+const SensorProfile *sensorProfile = NULL;  // Profile the base sensor is currently ranging with
+
+VL53L0X *const tireSensors[TIRE_SENSOR_COUNT] = { &Sensor_Tire1, &Sensor_Tire2 };   // Lowest tire first
+unsigned short tireSensorReadings[TIRE_SENSOR_COUNT] = { 999, 999 };    // Most recent reading of each tire sensor
+bool tireSensorReady[TIRE_SENSOR_COUNT];    // Whether each tire sensor initialized
+bool baseSensorReady;                       // Whether the base sensor initialized
+byte tireSensorIndex = 0;                   // Tire sensor polled next
+
 void setup(void) {
     // Setup pins
         // UART - Communication between PIC and Arduino
@@ -147,20 +259,13 @@ void setup(void) {
     pinMode(txPin, OUTPUT);
 
         // Encoder
-    // pinMode(encoder_master_pinA, INPUT);
-    // pinMode(encoder_master_pinB, INPUT);
-    // pinMode(encoder_slave_pinA, INPUT);
-    // pinMode(encoder_slave_pinB, INPUT);
-
-        // Sensor
-    // pinMode(XSHUT_sensor_base, OUTPUT);
-    // if (!debugMode) {
-        // pinMode(XSHUT_sensor_tire1, OUTPUT);
-        // pinMode(XSHUT_sensor_tire2, OUTPUT);
-    // }
+    pinMode(encoder_master_pinA, INPUT);
+    pinMode(encoder_slave_pinA, INPUT);
+    initializeEncoder();
 
         // Other
     pinMode(pole_detected_signal_pin, OUTPUT);
+    pinMode(sensor_base_gpio1_pin, INPUT_PULLUP);
 
     // Initialize serial communication at 9600 baud rate
     serialCom.begin(9600);
@@ -175,55 +280,12 @@ void setup(void) {
     delay(10);
     // Initialize Sensors
     debugMode = false;
+    initializeSensors();
 
-    // // Restart sensors
-    // if (debugMode) {
-    //     // Change the address of the enabled sensor (Sensor_Tire2)
-    //     pinMode(XSHUT_sensor_tire2, INPUT);
-    //     delay(10);
-    //     Sensor_Tire2.setAddress(Sensor_Tire2_Addr);
-    //     delay(10);
-    //     // Enable the next sensor
-    //     pinMode(XSHUT_sensor_tire1, INPUT);
-    //     delay(10);
-
-    //     // Change the address of the enabled sensor (Sensor_Tire1)
-    //     Sensor_Tire1.setAddress(Sensor_Tire1_Addr);
-    //     delay(10);
-    // }
-
-    // // Enable the base sensor
-    // delay(100);
-    // pinMode(XSHUT_sensor_base, OUTPUT);
-    // delay(10);
-    // pinMode(XSHUT_sensor_base, INPUT);
-    // delay(10);
-
-    // Initialize sensors
-    Sensor_Base.init();
-
-    // if (debugMode) {
-    //     Sensor_Tire1.init();
-    //     Sensor_Tire2.init();
-    // }
-
-    // Set timeouts for sensors
-    Sensor_Base.setTimeout(500);
-
-    // if (debugMode) {
-    //     Sensor_Tire1.setTimeout(1000);
-    //     Sensor_Tire2.setTimeout(1000);
-    // }
-
-    // Start the sensor continuously
-    Sensor_Base.startContinuous(10);
+    // Start the base sensor continuously with the fast profile
+    setSensorProfile(&fastSensorProfile);
     delay(50);
 
-    // if (debugMode) {
-    //     Sensor_Tire1.startContinuous(10);
-    //     Sensor_Tire2.startContinuous(10);
-    // }
-
     // Initialization complete, signal to the LED
     digitalWrite(pole_detected_signal_pin, HIGH);
     delay(100);
@@ -235,6 +297,9 @@ void setup(void) {
     pinMode(rightmotor_pinA, OUTPUT);
     pinMode(rightmotor_pinB, OUTPUT);
 
+    // Use the calibrated motor trim if one was stored
+    loadMotorTrim();
+
     randomSeed(analogRead(0));
 }
 
@@ -243,19 +308,76 @@ void setup(void) {
 byte currentState = IDLE;                  // Current state of the robot operation
 Operation currentOp;                        // Stores current operation data
 
-byte verificationCount;     // Keep track of the number of times the sensor measured a pole
+PoleDetector poleDetector;  // Tracks poles passing in front of the base sensor
+byte tirePlan[MAX_POLES];   // Tires to deploy on each pole, planned once every pole has been found
+byte operationMode;         // Whether the operation runs in a single pass or maps the poles first
+byte currentPole;           // Index of the pole being deployed on
+byte preparedPole;          // Pole the PIC was last asked to pre-roll a tire for (NO_POLE for none)
 byte tiresRequired;         // Keep track of the remaining number of tires to deploy
 bool isDriving;             // Keep track of whether robot is driving or not
 bool dbg;
-int tick = 0;
+unsigned long stateEnteredTime;     // Time (ms) the current state was entered
+SensorSample sampleBuffer[SAMPLE_BUFFER_SIZE];  // Readings of the base sensor waiting to be consumed
+byte sampleHead = 0;                // Index the next reading is stored at
+byte sampleCount = 0;               // Number of readings waiting in the buffer
+SensorSample latestSample;          // Most recent reading of the base sensor
+unsigned long lastSampleTime = 0;   // Time (ms) of the most recent reading
+unsigned short averageWindow[SENSOR_AVERAGE_WINDOW_MAX];    // Most recent readings of the base sensor
+byte averageHead = 0;               // Index the next reading is stored at
+byte averageCount = 0;              // Number of readings in the averaging window
+unsigned long averageSum = 0;       // Sum of the readings in the averaging window
+long distanceEmaQ4 = 0;             // Exponential average of the base sensor readings (4 fractional bits)
 unsigned short measuredAdjustmentDistance;
+byte alignSettledCount;     // Consecutive readings within the optimal range while aligning
+bool adjustmentRequested;   // Whether the PIC has been sent the adjustment for the current alignment reading
+unsigned long alignStartTime;   // Time (ms) the alignment started
+
+float trimSumX, trimSumY, trimSumXY, trimSumXX;    // Least squares sums of lateral distance against position
+byte trimSamples;           // Number of lateral readings taken during trim calibration
+
+volatile long masterEncoderTicks = 0;   // Quadrature ticks counted on the master (left) wheel
+volatile long slaveEncoderTicks = 0;    // Quadrature ticks counted on the slave (right) wheel
 
 byte pstates[10];
 
 void setState(byte newState);
+void serviceSerial(void);
+bool readSerialByte(byte *value);
+void reportSerialReadTimeout(void);
+void sampleSensor(void);
+void sampleTireSensors(void);
+void updateOdometry(void);
+void updateState(void);
+
+// Periodic tasks run cooperatively from loop(), each at its own rate
+Task tasks[] = {
+    { serviceSerial, SERIAL_TASK_INTERVAL_MS, 0 },
+    { sampleSensor, SENSOR_TASK_INTERVAL_MS, 0 },
+    { sampleTireSensors, TIRE_SENSOR_TASK_INTERVAL_MS, 0 },
+    { updateOdometry, ODOMETRY_TASK_INTERVAL_MS, 0 },
+    { updateState, STATE_TASK_INTERVAL_MS, 0 }
+};
+#define TASK_COUNT (sizeof(tasks) / sizeof(tasks[0]))
 
 void loop(void) {
+    // Run every task whose interval has elapsed
+    unsigned long now = millis();
+    for (byte i = 0; i < TASK_COUNT; i++) {
+        if (now - tasks[i].lastRun >= tasks[i].intervalMs) {
+            tasks[i].lastRun = now;
+            tasks[i].run();
+        }
+    }
+
+    // While waiting for the PIC, sleep until the next interrupt. Idle mode keeps the timers running, so
+    // the millis() tick or a byte arriving on the serial pins wakes it
+    if (currentState == IDLE && serialCom.available() == 0) {
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_mode();
+    }
+}
 
+void serviceSerial(void) {
     // Check for available messages from the PIC
     if (serialCom.available() > 0) {
         byte byteReceived = serialCom.read();
@@ -271,14 +393,27 @@ void loop(void) {
               // Reset current operations
                 currentOp.totalNumberOfPoles = 0;
                 currentOp.totalSuppliedTires = 0;
-                currentOp.position_in_mm = 0;
-                currentOp.tiresRemaining = 5;
+                resetOdometry();
+                resetPoleDetector();
+                preparedPole = NO_POLE;
+
+                // The PIC follows the start signal with the number of tires in its magazine and the operation mode
+                if (!readSerialByte(&currentOp.tiresRemaining) || !readSerialByte(&operationMode)) {
+                    reportSerialReadTimeout();
+                    break;
+                }
 
-                setState(DRIVING);
+                setState(operationMode == OP_MODE_TWO_PASS ? MAPPING : DRIVING);
                 break;
 
             case MSG_P2A_DEPLOYMENT_COMPLETE:
             // Receive stepper deployment complete signal, revert state to POLE_DETECTED
+                // The PIC's magazine model follows with the number of tires remaining
+                if (!readSerialByte(&currentOp.tiresRemaining)) {
+                    reportSerialReadTimeout();
+                    break;
+                }
+
                 setState(POLE_DETECTED);
                 break;
 
@@ -300,22 +435,22 @@ void loop(void) {
             case MSG_P2A_DEBUG_SENSOR_BASE:
             // Receive signal to request sensor_base data
                 // Send data for Sensor_Base
-                serialCom.write((byte)(readSensor(Sensor_Base) >> 8));
-                serialCom.write((byte)(readSensor(Sensor_Base) & 0xFF));
+                serialCom.write((byte)(latestSample.distance >> 8));
+                serialCom.write((byte)(latestSample.distance & 0xFF));
+                break;
 
             case MSG_P2A_DEBUG_SENSOR_TIRE1:
             // Receive signal to request sensor_tire1 data
-                delay(10);
-                // // Send data for Sensor_Tire1
-                // serialCom.write((byte)(readSensor(Sensor_Tire1) >> 8));
-                // serialCom.write((byte)(readSensor(Sensor_Tire1) & 0xFF));
+                // Send data for Sensor_Tire1
+                serialCom.write((byte)(tireSensorReadings[0] >> 8));
+                serialCom.write((byte)(tireSensorReadings[0] & 0xFF));
+                break;
 
             case MSG_P2A_DEBUG_SENSOR_TIRE2:
             // Receive signal to request sensor_tire2 data
-                delay(10);
                 // Send data for Sensor_Tire2
-                // serialCom.write((byte)(readSensor(Sensor_Tire2) >> 8));
-                // serialCom.write((byte)(readSensor(Sensor_Tire2) & 0xFF));
+                serialCom.write((byte)(tireSensorReadings[1] >> 8));
+                serialCom.write((byte)(tireSensorReadings[1] & 0xFF));
                 break;
 
             case MSG_P2A_REQUEST_INITIALIZE_SENSOR:
@@ -324,12 +459,9 @@ void loop(void) {
                 break;
 
             case MSG_P2A_REQUEST_STATUS_SENSORS:
-                serialWriteSuccessOrFail(Sensor_Base.getAddress() == Sensor_Base_Addr);
-                // if (debugMode) {
-                //     serialWriteSuccessOrFail(Sensor_Tire1.getAddress() == Sensor_Tire1_Addr);
-                //     serialWriteSuccessOrFail(Sensor_Tire2.getAddress() == Sensor_Tire2_Addr);
-                // }
-                
+                serialWriteSuccessOrFail(baseSensorReady && Sensor_Base.getAddress() == Sensor_Base_Addr);
+                serialWriteSuccessOrFail(tireSensorReady[0] && Sensor_Tire1.getAddress() == Sensor_Tire1_Addr);
+                serialWriteSuccessOrFail(tireSensorReady[1] && Sensor_Tire2.getAddress() == Sensor_Tire2_Addr);
                 break;
 
             case MSG_P2A_REQUEST_POSITION:
@@ -346,9 +478,11 @@ void loop(void) {
                 break;
 
             case MSG_P2A_OP_DEBUG:
+            // The PIC is on a debug screen and not listening for a reply, so a timeout just drops the message
                 for (byte i = 0; i < 10; i++) {
-                    while (!serialCom.available()) {continue;}
-                    pstates[i] = serialCom.read();
+                    if (!readSerialByte(&pstates[i])) {
+                        break;
+                    }
                     dbg = true;
                 }
                 break;
@@ -357,6 +491,21 @@ void loop(void) {
                 setState(ADJUSTING);
                 break;
 
+            case MSG_P2A_CALIBRATE_TRIM:
+            // Drive a reference run alongside a straight wall to fit the motor trim
+                setState(CALIBRATING);
+                break;
+
+            case MSG_P2A_PROBE_DUMP:
+            // The PIC's timing probe table follows as text for a serial monitor on the line, skip it up to the terminating 0
+                {
+                    byte skipped;
+                    while (readSerialByte(&skipped) && skipped != 0) {
+                        continue;
+                    }
+                }
+                break;
+
             default:
                 // Turn off motors and disable pole_detected_signal_pin
                 driveMotors(MOTORSTATE_OFF);
@@ -366,10 +515,205 @@ void loop(void) {
             return;
         }
     }
+}
+
+// Reads the next byte of a message from the PIC, giving up after SERIAL_READ_TIMEOUT_MS so the tasks keep running
+bool readSerialByte(byte *value) {
+    unsigned long start = millis();
+    while (!serialCom.available()) {
+        if (millis() - start > SERIAL_READ_TIMEOUT_MS) {
+            return false;
+        }
+    }
+
+    *value = serialCom.read();
+    return true;
+}
+
+// Stops the robot and tells the PIC that the rest of its message never arrived
+void reportSerialReadTimeout(void) {
+    setState(IDLE);
+    serialCom.write(MSG_A2P_UART_READ_TIMEOUT);
+}
+
+void sampleSensor(void) {
+    // The sensor pulls GPIO1 low once a new reading is ready, and holds it until the interrupt is cleared
+    if (digitalRead(sensor_base_gpio1_pin) == HIGH) {
+        // Report a timeout if no reading arrived for too long during an operation
+        if (currentState != IDLE && currentState != COMPLETE && millis() - lastSampleTime > SENSOR_TIMEOUT_MS) {
+            serialCom.write(MSG_A2P_SENSOR_TIMEOUT);
+            lastSampleTime = millis();
+        }
+        return;
+    }
+
+    // Fetch the result and clear the interrupt so the sensor can signal the next reading
+    unsigned short measuredVal = Sensor_Base.readReg16Bit(VL53L0X::RESULT_RANGE_STATUS + 10);
+    Sensor_Base.writeReg(VL53L0X::SYSTEM_INTERRUPT_CLEAR, 0x01);
+
+    lastSampleTime = millis();
+    latestSample.distance = measuredVal > 999 ? 999 : measuredVal;
+    latestSample.time = lastSampleTime;
+    latestSample.position = currentOp.position_in_mm;
+
+    updateSensorAverage(latestSample.distance);
+
+    // Store the reading, dropping the oldest one if the buffer is full
+    sampleBuffer[sampleHead] = latestSample;
+    sampleHead = (sampleHead + 1) % SAMPLE_BUFFER_SIZE;
+    if (sampleCount < SAMPLE_BUFFER_SIZE) {
+        sampleCount++;
+    }
+}
+
+void sampleTireSensors(void) {
+    // Poll one tire sensor per run, fetching its result only once it has a reading ready
+    VL53L0X &sensor = *tireSensors[tireSensorIndex];
+    if (tireSensorReady[tireSensorIndex] && (sensor.readReg(VL53L0X::RESULT_INTERRUPT_STATUS) & 0x07) != 0) {
+        unsigned short measuredVal = sensor.readReg16Bit(VL53L0X::RESULT_RANGE_STATUS + 10);
+        sensor.writeReg(VL53L0X::SYSTEM_INTERRUPT_CLEAR, 0x01);
+        tireSensorReadings[tireSensorIndex] = measuredVal > 999 ? 999 : measuredVal;
+    }
+
+    tireSensorIndex = (tireSensorIndex + 1) % TIRE_SENSOR_COUNT;
+}
+
+byte countTiresOnPole(void) {
+    // The lowest sensor sees the first tire on a pole, and the next sensor sees the second
+    if (tireSensorReadings[0] > TIRE_DETECTED_RANGE) {
+        return 0;
+    } else if (tireSensorReadings[1] > TIRE_DETECTED_RANGE) {
+        return 1;
+    } else {
+        return 2;
+    }
+}
+
+void resetPoleDetector(void) {
+    poleDetector.head = 0;
+    poleDetector.count = 0;
+    poleDetector.inView = false;
+}
+
+byte updatePoleDetector(const SensorSample *sample) {
+    // Add the reading to the window, overwriting the oldest one
+    poleDetector.distance[poleDetector.head] = sample->distance;
+    poleDetector.position[poleDetector.head] = sample->position;
+    poleDetector.head = (poleDetector.head + 1) % POLE_MEDIAN_WINDOW;
+    if (poleDetector.count < POLE_MEDIAN_WINDOW) {
+        poleDetector.count++;
+        return POLE_EVENT_NONE;
+    }
+
+    // Take the median of the window with an insertion sort (the window is a handful of readings)
+    unsigned short sorted[POLE_MEDIAN_WINDOW];
+    for (byte i = 0; i < POLE_MEDIAN_WINDOW; i++) {
+        unsigned short value = poleDetector.distance[i];
+        byte j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    unsigned short median = sorted[POLE_MEDIAN_WINDOW / 2];
+
+    // The median lags by half a window, so edges are placed at the position of the middle reading
+    unsigned short edgePosition = poleDetector.position[(poleDetector.head + POLE_MEDIAN_WINDOW / 2) % POLE_MEDIAN_WINDOW];
+
+    // Enter and exit at different ranges so noise around a single threshold cannot double count a pole
+    if (!poleDetector.inView && median < POLE_DETECTED_RANGE) {
+        poleDetector.inView = true;
+        poleDetector.entryPosition = edgePosition;
+        return POLE_EVENT_ENTERED;
+    } else if (poleDetector.inView && median > POLE_CLEARED_RANGE) {
+        poleDetector.inView = false;
+        poleDetector.exitPosition = edgePosition;
+        return POLE_EVENT_EXITED;
+    }
+
+    return POLE_EVENT_NONE;
+}
+
+void resetSensorAverage(void) {
+    averageHead = 0;
+    averageCount = 0;
+    averageSum = 0;
+}
+
+void updateSensorAverage(unsigned short distance) {
+    // Slide the window over the readings of the sensor profile, keeping a running sum
+    byte window = sensorProfile->averagingSamples;
+    if (averageCount == window) {
+        averageSum -= averageWindow[(averageHead + SENSOR_AVERAGE_WINDOW_MAX - window) % SENSOR_AVERAGE_WINDOW_MAX];
+    } else {
+        averageCount++;
+    }
+    averageWindow[averageHead] = distance;
+    averageHead = (averageHead + 1) % SENSOR_AVERAGE_WINDOW_MAX;
+    averageSum += distance;
+
+    // The exponential average starts from the first reading of the window
+    if (averageCount == 1) {
+        distanceEmaQ4 = (long)distance << 4;
+    } else {
+        distanceEmaQ4 += (((long)distance << 4) - distanceEmaQ4) >> SENSOR_EMA_SHIFT;
+    }
+}
+
+bool sensorAverageReady(void) {
+    // The window is full once it holds as many readings as the sensor profile averages
+    return averageCount >= sensorProfile->averagingSamples;
+}
+
+unsigned short windowedSensorAverage(void) {
+    return averageCount ? averageSum / averageCount : 0;
+}
+
+unsigned short smoothedSensorReading(void) {
+    return (unsigned short)((distanceEmaQ4 + 8) >> 4);
+}
+
+bool trackPoles(const SensorSample *sample) {
+    // Record the poles passing the base sensor, returning whether a new pole came into view
+    byte poleEvent = updatePoleDetector(sample);
+
+    if (poleEvent == POLE_EVENT_EXITED && currentOp.totalNumberOfPoles > 0) {
+        // The previous pole has left the sensor's view, so its centre lies between where it entered and exited.
+        // Only reached while mapping, where the robot drives past the poles and returns to these centres
+        currentOp.distanceOfPole[currentOp.totalNumberOfPoles - 1] = (poleDetector.entryPosition + poleDetector.exitPosition) / 2;
+    } else if (poleEvent == POLE_EVENT_ENTERED) {
+        // Pole was detected, update operation data
+        currentOp.totalNumberOfPoles++;
+        currentOp.tiresDeployedOnPole[currentOp.totalNumberOfPoles - 1] = 0;
+        currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1] = countTiresOnPole();
+        currentOp.distanceOfPole[currentOp.totalNumberOfPoles - 1] = poleDetector.entryPosition;
+        if (dbg) {
+            currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1] = pstates[currentOp.totalNumberOfPoles - 1];
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool takeSensorSample(SensorSample *sample) {
+    // Consume the oldest buffered base sensor reading, if any
+    if (sampleCount == 0) {
+        return false;
+    }
+
+    *sample = sampleBuffer[(sampleHead + SAMPLE_BUFFER_SIZE - sampleCount) % SAMPLE_BUFFER_SIZE];
+    sampleCount--;
+    return true;
+}
 
+void updateState(void) {
     // Operation variables
     unsigned short distanceMeasured;   // Measured value of the sensor distance
+    SensorSample sample;    // Reading taken from the base sensor
     bool isSearching;       // Controls if the robot will be searching for poles
+    unsigned short searchStart; // Position after which a new pole can be detected
     // Operate depending on the state of the robot
     switch (currentState) {
 
@@ -385,117 +729,173 @@ void loop(void) {
                 break;
             }
             
-            // Do not search until minimum distance for first pole is reached. Also do not search if recently found a pole.
-            if ((currentOp.position_in_mm > FIRST_POLE_MIN_DISTANCE_MM) && 
-                (currentOp.totalNumberOfPoles == 0 || currentOp.position_in_mm - currentOp.distanceOfPole[currentOp.totalNumberOfPoles - 1] > POLE_DETECTED_BUFFER_REGION)) {
-                
-                isSearching = true;
-            } else {
-                isSearching = false;
+            // Do not search until minimum distance for first pole is reached
+            isSearching = currentOp.position_in_mm > FIRST_POLE_MIN_DISTANCE_MM;
+            if (!isSearching) {
                 digitalWrite(pole_detected_signal_pin, HIGH);
             }
-            
-            // Check for poles while searching
-            if (isSearching) {
-
-                // Measure the distance seen by the sensor
-                distanceMeasured = readSensor(Sensor_Base);
-
-                // Check if the distance measured is within the range of the maximum pole distance
-                if (distanceMeasured < POLE_DETECTED_RANGE) {
-                    if (verificationCount >= VALID_VERIFICATION_COUNT) {
-                        // If the pole was detected VALID_VERIFICATION_COUNT times
-
-                        // Pole was detected, update operation data
-                        currentOp.totalNumberOfPoles++;
-                        currentOp.tiresDeployedOnPole[currentOp.totalNumberOfPoles - 1] = 0;
-                        currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1] = random(0, 2);
-                        currentOp.distanceOfPole[currentOp.totalNumberOfPoles - 1] = currentOp.position_in_mm;
-                        if (dbg) {
-                            currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1] = pstates[currentOp.totalNumberOfPoles - 1];
-                        }
-                        
-                        // Decide whether the pole requires 1 or 2 tires
-                        // The first pole and every pole that is further than 30cm from the previous pole requires 2 tires
-                        if ((currentOp.totalNumberOfPoles == 1) || currentOp.position_in_mm - currentOp.distanceOfPole[currentOp.totalNumberOfPoles - 1] >= 300) {
-                            tiresRequired = 2;
-                        } else {
-                            tiresRequired = 1;
-                        }
-
-                        tiresRequired -= currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1];
-
-
-                        // // Check if tires are currently on the pole
-                        // if ((readSensor(Sensor_Tire1) <= TIRE_DETECTED_RANGE) && readSensor(Sensor_Tire2) <= TIRE_DETECTED_RANGE) {
-                        //     // 2 tires already on pole, do not need to deploy under any circumstance & record data in operation
-                        //     currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1] = 2;
-                        //     tiresRequired = 0;
-                        // } else if (readSensor(Sensor_Tire1) <= TIRE_DETECTED_RANGE) {
-                        //     // 1 tire already on pole, reduce the number of tires required by 1 & record data in operation
-                        //     tiresRequired -= 1;
-                        //     currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1] = 1;
-                        // }
-
-                        // Reset verification count
-                        verificationCount = 0;
-
-                        // Signal that a pole was detected by setting state to POLE_DETECTED
-                        setState(POLE_DETECTED);
 
-                    } else {
-                        // If the pole was detected but not enough times
-
-                        // Increment verification count and stop driving while verifying
-                        verificationCount++;
-                        // if (isDriving) {
-                        //     isDriving = false;
-                        //     driveMotors(MOTORSTATE_OFF);
-                        // }
-                    }
-                } else {
-                    // If no objects were sensed in the range, continue driving
-                    verificationCount = 0;
-                    // if (!isDriving) {
-                    //     isDriving = true;
-                    //     driveMotors(MOTORSTATE_FORWARD);
-                    // }
-                    currentOp.position_in_mm += DRIVESPEED_MM_PER_SECOND / 10;
-                }
+            // No new pole can appear until the minimum spacing past the previous pole
+            if (currentOp.totalNumberOfPoles == 0) {
+                searchStart = FIRST_POLE_MIN_DISTANCE_MM;
+            } else {
+                searchStart = currentOp.distanceOfPole[currentOp.totalNumberOfPoles - 1] + MIN_POLE_SPACING_MM;
+            }
+
+            // Keep the robot driving straight from the difference in wheel travel
+            if (ONLINE_TRIM_CORRECTION) {
+                updateTrimCorrection();
+            }
 
+            // Cruise where no pole can be detected, and drive at the search duty while the sensor is sampling
+            if (currentOp.position_in_mm + CRUISE_BRAKING_MM < searchStart) {
+                driveMotorsAtDuty(MOTORSTATE_FORWARD, CRUISE_DUTY);
             } else {
-                currentOp.position_in_mm += DRIVESPEED_MM_PER_SECOND / 10;
+                driveMotors(MOTORSTATE_FORWARD);
+            }
+            
+            // Feed every new sensor reading past the search start through the pole detector, so the pole the
+            // robot last stopped at cannot be detected again once it drives on
+            if (isSearching && takeSensorSample(&sample) && sample.position > searchStart && trackPoles(&sample)) {
+                // Decide how many tires to deploy on the pole
+                currentPole = currentOp.totalNumberOfPoles - 1;
+                tiresRequired = tiresRequiredForPole(currentPole);
+
+                // The robot stops at the entry edge, so the readings in the window are stale once it drives on
+                resetPoleDetector();
+
+                // Signal that a pole was detected by setting state to POLE_DETECTED
+                setState(POLE_DETECTED);
+            }
+
+            break;
+
+        case MAPPING:
+            // Once the whole course is mapped, plan the tires for every pole and deploy on the way back
+            if (currentOp.position_in_mm >= MAX_DISTANCE_MM || currentOp.totalNumberOfPoles == MAX_POLES) {
+                planTireAllocation(currentOp.totalNumberOfPoles, currentOp.tiresRemaining);
+                currentPole = currentOp.totalNumberOfPoles;
+                approachNextPole();
+                break;
+            }
+
+            // Keep the robot driving straight from the difference in wheel travel
+            if (ONLINE_TRIM_CORRECTION) {
+                updateTrimCorrection();
+            }
+            driveMotorsAtDuty(MOTORSTATE_FORWARD, MAPPING_DUTY);
+
+            // Only record the poles while mapping, without stopping
+            if (currentOp.position_in_mm > FIRST_POLE_MIN_DISTANCE_MM && takeSensorSample(&sample)) {
+                trackPoles(&sample);
             }
+            break;
 
+        case APPROACHING:
+            // Stop at the mapped centre of the pole and deploy the planned tires
+            if (currentOp.position_in_mm <= currentOp.distanceOfPole[currentPole]) {
+                tiresRequired = tirePlan[currentPole];
+                setState(POLE_DETECTED);
+            } else if (currentOp.position_in_mm < currentOp.distanceOfPole[currentPole] + APPROACH_SLOWDOWN_MM) {
+                driveMotors(MOTORSTATE_BACKWARD);
+            }
             break;
 
         case POLE_DETECTED:
             // Check if can deploy
             if (tiresRequired > 0 && currentOp.tiresRemaining > 0) {
-                delay(100);
-                setState(ADJUSTING);
+                // Let the robot settle before adjusting
+                if (millis() - stateEnteredTime >= POLE_SETTLE_MS) {
+                    setState(ADJUSTING);
+                }
+            } else if (operationMode == OP_MODE_TWO_PASS) {
+                // Otherwise move on to the next planned pole
+                approachNextPole();
             } else {
                 // Otherwise continue driving
                 setState(DRIVING);
-                // delay(500); (HACKY WAY OF NOT DETECTING THE SAME POLE)
             }
             
             break;
 
         case ADJUSTING:
+            if (!ALIGN_ON_ARDUINO) {
+                // Once a full window was read since the last adjustment, tell the PIC which way to adjust,
+                // followed by the error (mm) from the optimal range
+                if (!adjustmentRequested && sensorAverageReady()) {
+                    adjustmentRequested = true;
+                    measuredAdjustmentDistance = windowedSensorAverage();
+                    if (measuredAdjustmentDistance > OPTIMAL_MAX_RANGE) {
+                        serialCom.write(MSG_A2P_ADJUST_TOWARDS);
+                        serialCom.write((byte)min(measuredAdjustmentDistance - OPTIMAL_RANGE, 255));
+                    } else if (measuredAdjustmentDistance < OPTIMAL_MIN_RANGE) {
+                        serialCom.write(MSG_A2P_ADJUST_AWAY);
+                        serialCom.write((byte)(OPTIMAL_RANGE - measuredAdjustmentDistance));
+                    } else {
+                        setState(DEPLOYING);
+                    }
+                }
+
+                // The PIC performs the adjustment and replies with MSG_P2A_ADJUSTMENT_COMPLETE
+                break;
+            }
+
+            // Act on every new reading once the averaging window has filled, reading the averages the sensor task maintains
+            if (takeSensorSample(&sample) && sensorAverageReady()) {
+                distanceMeasured = windowedSensorAverage();
+                if (distanceMeasured >= OPTIMAL_MIN_RANGE && distanceMeasured <= OPTIMAL_MAX_RANGE) {
+                    driveMotors(MOTORSTATE_OFF);
+                    alignSettledCount++;
+                } else {
+                    // Steer from the exponential average, which lags the motion less than the window
+                    alignSettledCount = 0;
+                    int alignmentError = (int)smoothedSensorReading() - OPTIMAL_RANGE;
+                    byte duty = constrain(abs(alignmentError) * ALIGN_GAIN, ALIGN_MIN_DUTY, ALIGN_MAX_DUTY);
+                    driveMotorsAtDuty(alignmentError > 0 ? ALIGN_TOWARDS : ALIGN_AWAY, duty);
+                }
+            }
+
+            // Once settled, tell the PIC the robot is aligned and deploy
+            if (alignSettledCount >= ALIGN_SETTLE_COUNT) {
+                driveMotors(MOTORSTATE_OFF);
+                serialCom.write(MSG_A2P_ALIGNED);
+                setState(DEPLOYING);
+            } else if (millis() - alignStartTime > ALIGN_TIMEOUT_MS) {
+                // Out of time, deploy where the robot stopped and tell the PIC how far (mm) it is from the optimal range
+                driveMotors(MOTORSTATE_OFF);
+                serialCom.write(MSG_A2P_ALIGN_TIMEOUT);
+                serialCom.write((byte)min(abs((int)smoothedSensorReading() - OPTIMAL_RANGE), 255));
+                setState(DEPLOYING);
+            }
             break;
 
         case DEPLOYING:
             // Deploy a tire (does nothing within loop, all actions are performed initially)
-            delay(100);
             break;
 
         case RETURNING:
             // Drive backwards until returned to start position
             if (currentOp.position_in_mm == 0) {
                 setState(COMPLETE);
-            } else {
-                currentOp.position_in_mm-= DRIVESPEED_MM_PER_SECOND / 10;
+            } else if (currentOp.position_in_mm < RETURN_SLOWDOWN_MM) {
+                driveMotors(MOTORSTATE_BACKWARD);
+            }
+            break;
+
+        case CALIBRATING:
+            // Record the lateral distance to the reference wall along the run
+            if (takeSensorSample(&sample) && sample.distance < TRIM_REFERENCE_RANGE) {
+                trimSumX += sample.position;
+                trimSumY += sample.distance;
+                trimSumXY += (float)sample.position * sample.distance;
+                trimSumXX += (float)sample.position * sample.position;
+                trimSamples++;
+            }
+
+            if (currentOp.position_in_mm >= TRIM_CALIBRATION_DISTANCE_MM) {
+                driveMotors(MOTORSTATE_OFF);
+                fitMotorTrim();
+                setState(IDLE);
             }
             break;
 
@@ -503,23 +903,23 @@ void loop(void) {
             break;
     }
 
-    // Loop delay time
-    delay(100);
-    tick++;
-    if (tick == 1000) {
-        tick = 0;
-    }
-   
 }
 
 void setState(byte newState) {
     // Changes the state of the robot and performs an initial function upon state change
     currentState = newState;
+    stateEnteredTime = millis();
+
+    // Readings taken before the state change are stale
+    sampleCount = 0;
 
     // Disable motors and pole detected signal by default
     driveMotors(MOTORSTATE_OFF);
     digitalWrite(pole_detected_signal_pin, LOW);
 
+    // Align with the accurate sensor profile, and range quickly everywhere else
+    setSensorProfile(newState == ADJUSTING ? &accurateSensorProfile : &fastSensorProfile);
+
     // Perform an initial function dependant on the new state
     switch (newState) {
         case IDLE:
@@ -530,9 +930,8 @@ void setState(byte newState) {
             // Tell PIC that robot is driving (to update LCD)
             serialCom.write(MSG_A2P_DRIVING);
 
-            // Set motors to drive forward and reset verificationCount
+            // Set motors to drive forward
             driveMotors(MOTORSTATE_FORWARD);
-            verificationCount = 0;
             break;
 
         case POLE_DETECTED:
@@ -544,13 +943,23 @@ void setState(byte newState) {
             break;
 
         case ADJUSTING:
-            measuredAdjustmentDistance = takeAverageSensorReading(Sensor_Base, 5);
-            if (measuredAdjustmentDistance > OPTIMAL_MAX_RANGE) {
-                serialCom.write(MSG_A2P_ADJUST_TOWARDS);
-            } else if (measuredAdjustmentDistance < OPTIMAL_MIN_RANGE) {
-                serialCom.write(MSG_A2P_ADJUST_AWAY);
+            // Only average readings taken at the current position
+            resetSensorAverage();
+
+            // Overlap the start of the stepper move with the alignment (the tire is only dropped once aligned)
+            // Only once per pole, ADJUSTING is entered again after every nudge the PIC makes
+            if (PIPELINED_DEPLOYMENT && preparedPole != currentPole) {
+                serialCom.write(MSG_A2P_PREPARE_DEPLOY);
+                preparedPole = currentPole;
+            }
+
+            if (ALIGN_ON_ARDUINO) {
+                // The alignment loop runs in loop() against live sensor readings
+                alignSettledCount = 0;
+                alignStartTime = millis();
             } else {
-                setState(DEPLOYING);
+                // The adjustment is sent to the PIC from loop() once the averaging window fills
+                adjustmentRequested = false;
             }
             break;
 
@@ -563,19 +972,42 @@ void setState(byte newState) {
             tiresRequired--;
             // Update current operation data
             currentOp.totalSuppliedTires++;
-            currentOp.tiresDeployedOnPole[currentOp.totalNumberOfPoles - 1]++;
-            currentOp.tiresOnPoleAfterOperation[currentOp.totalNumberOfPoles - 1]++;
-            currentOp.tiresRemaining--;
+            currentOp.tiresDeployedOnPole[currentPole]++;
+            currentOp.tiresOnPoleAfterOperation[currentPole]++;
             break;
 
         case RETURNING:
             // Tell PIC that robot is returning (to update LCD)
             serialCom.write(MSG_A2P_RETURNING);
 
-            // Drive motors in reverse
-            driveMotors(MOTORSTATE_BACKWARD);
+            // Drive motors in reverse at full return speed
+            driveMotorsAtDuty(MOTORSTATE_BACKWARD, RETURN_DUTY);
+            break;
+
+        case MAPPING:
+            // Tell PIC that robot is mapping the poles (to update LCD)
+            serialCom.write(MSG_A2P_MAPPING);
+
+            // Drive forward at the mapping speed
+            driveMotorsAtDuty(MOTORSTATE_FORWARD, MAPPING_DUTY);
+            break;
+
+        case APPROACHING:
+            // Tell PIC that robot is driving (to update LCD)
+            serialCom.write(MSG_A2P_DRIVING);
+
+            // Drive back towards the pole quickly, slowing down once it is close
+            driveMotorsAtDuty(MOTORSTATE_BACKWARD, APPROACH_DUTY);
+            break;
+
+        case CALIBRATING:
+            // Start the reference run from a known position
+            resetOdometry();
+            trimSumX = trimSumY = trimSumXY = trimSumXX = 0;
+            trimSamples = 0;
+            trimCorrection = 0;
 
-            currentOp.position_in_mm += 500;
+            driveMotors(MOTORSTATE_FORWARD);
             break;
 
         case COMPLETE:
@@ -598,7 +1030,7 @@ void setState(byte newState) {
             // for now just reset operation
             currentOp.totalNumberOfPoles = 0;
             currentOp.totalSuppliedTires = 0;
-            currentOp.position_in_mm = 0;
+            resetOdometry();
             break;
 
         default:
@@ -606,8 +1038,66 @@ void setState(byte newState) {
     }
 }
 
+bool startSensor(VL53L0X &sensor, byte xshutPin, byte address) {
+    // Release the sensor from shutdown (the breakout pulls XSHUT up) and let it boot on the default address
+    pinMode(xshutPin, INPUT);
+    delay(10);
+
+    sensor.setTimeout(500);
+    if (!sensor.init()) {
+        return false;
+    }
+
+    // Move the sensor off the default address before the next one boots
+    if (address != Sensor_Base_Addr) {
+        sensor.setAddress(address);
+    }
+    return true;
+}
+
+void initializeSensors(void) {
+    // Hold every sensor in shutdown so each can be given its own address in turn
+    pinMode(XSHUT_sensor_base, OUTPUT);
+    pinMode(XSHUT_sensor_tire1, OUTPUT);
+    pinMode(XSHUT_sensor_tire2, OUTPUT);
+    digitalWrite(XSHUT_sensor_base, LOW);
+    digitalWrite(XSHUT_sensor_tire1, LOW);
+    digitalWrite(XSHUT_sensor_tire2, LOW);
+    delay(10);
+
+    tireSensorReady[0] = startSensor(Sensor_Tire1, XSHUT_sensor_tire1, Sensor_Tire1_Addr);
+    tireSensorReady[1] = startSensor(Sensor_Tire2, XSHUT_sensor_tire2, Sensor_Tire2_Addr);
+    baseSensorReady = startSensor(Sensor_Base, XSHUT_sensor_base, Sensor_Base_Addr);
+
+    // The tire sensors range back-to-back on their own and are only polled for results
+    for (byte i = 0; i < TIRE_SENSOR_COUNT; i++) {
+        if (tireSensorReady[i]) {
+            tireSensors[i]->setMeasurementTimingBudget(TIRE_SENSOR_TIMING_BUDGET_US);
+            tireSensors[i]->startContinuous(0);
+        }
+    }
+}
+
+void setSensorProfile(const SensorProfile *profile) {
+    // Ranging only has to restart when the timing budget changes
+    if (profile == sensorProfile) {
+        return;
+    }
+    sensorProfile = profile;
+
+    Sensor_Base.stopContinuous();
+    Sensor_Base.setMeasurementTimingBudget(profile->timingBudgetUs);
+
+    // Range back-to-back so a reading is ready every timing budget
+    Sensor_Base.startContinuous(0);
+
+    // Readings buffered with the previous profile are stale
+    sampleCount = 0;
+    resetSensorAverage();
+}
+
 // Read the value of the specified sensor
-unsigned short readSensor(VL53L0X sensor) {
+unsigned short readSensor(VL53L0X &sensor) {
     // Read the sensor
     unsigned int measuredVal = sensor.readRangeContinuousMillimeters();
     if (sensor.timeoutOccurred()) {
@@ -621,39 +1111,73 @@ unsigned short readSensor(VL53L0X sensor) {
     }
 }
 
-unsigned short takeAverageSensorReading(VL53L0X sensor, byte numberOfReadings) {
-    // Keep track of the total readings
-    unsigned long summedReadings = 0;
-
-    // Add each reading to the total
-    for (byte i = 0; i < numberOfReadings; i++) {
-        summedReadings += readSensor(sensor);
-        // Provide a small delay for better data
-        delay(1);
+void loadMotorTrim(void) {
+    // Restore the motor trim from EEPROM if a calibration was stored
+    if (EEPROM.read(TRIM_EEPROM_ADDR) == TRIM_EEPROM_MAGIC) {
+        leftmotor_speed = EEPROM.read(TRIM_EEPROM_ADDR + 1);
+        rightmotor_speed = EEPROM.read(TRIM_EEPROM_ADDR + 2);
     }
+}
 
-    // Take the average by dividing by the number of readings
-    unsigned int averageReading = summedReadings / numberOfReadings;
+void fitMotorTrim(void) {
+    // Fit the lateral drift (mm per mm travelled) with least squares and correct the right motor
+    if (trimSamples < TRIM_MIN_SAMPLES) {
+        return;
+    }
 
-    // If the average reading is more than 0xFF, return 0xFF otherwise return average value
-    if (averageReading > 999) {
-        return 999;
-    } else {
-        return (unsigned short)averageReading;
+    float denominator = trimSamples * trimSumXX - trimSumX * trimSumX;
+    if (denominator == 0) {
+        return;
     }
+    float slope = (trimSamples * trimSumXY - trimSumX * trimSumY) / denominator;
+
+    int newRightSpeed = rightmotor_speed + (int)(slope * TRIM_DUTY_PER_SLOPE);
+    rightmotor_speed = constrain(newRightSpeed, 1, 255);
+
+    // Store the trim so it survives a power cycle
+    EEPROM.update(TRIM_EEPROM_ADDR + 1, leftmotor_speed);
+    EEPROM.update(TRIM_EEPROM_ADDR + 2, rightmotor_speed);
+    EEPROM.update(TRIM_EEPROM_ADDR, TRIM_EEPROM_MAGIC);
+}
+
+void updateTrimCorrection(void) {
+    // When the left (master) wheel has travelled further the robot veers right, so speed up the right motor
+    noInterrupts();
+    long tickDifference = masterEncoderTicks - slaveEncoderTicks;
+    interrupts();
+
+    trimCorrection = constrain((tickDifference * ONLINE_TRIM_GAIN_Q4) >> 4, -ONLINE_TRIM_MAX, ONLINE_TRIM_MAX);
 }
 
 void driveMotors(byte motorState) {
+  driveMotorsAtDuty(motorState, leftmotor_speed);
+}
+
+void driveMotorsAtDuty(byte motorState, byte duty) {
+  // Drive at the given left motor duty, scaling the right motor to keep the left/right trim
+  byte leftDuty = duty;
+  int rightDuty = (unsigned int)duty * rightmotor_speed / leftmotor_speed;
   if (motorState == MOTORSTATE_FORWARD) {
-    analogWrite(leftmotor_pinA, leftmotor_speed);
+    rightDuty += trimCorrection;
+  }
+  rightDuty = max(rightDuty, 0);
+
+  // When the right motor would need more than full duty, slow the left motor instead so the robot still drives straight
+  if (rightDuty > 255) {
+    leftDuty = (unsigned int)leftDuty * 255 / rightDuty;
+    rightDuty = 255;
+  }
+
+  if (motorState == MOTORSTATE_FORWARD) {
+    analogWrite(leftmotor_pinA, leftDuty);
     analogWrite(leftmotor_pinB, 0);
-    analogWrite(rightmotor_pinA, rightmotor_speed);
+    analogWrite(rightmotor_pinA, rightDuty);
     analogWrite(rightmotor_pinB, 0);
   } else if (motorState == MOTORSTATE_BACKWARD) {
     analogWrite(leftmotor_pinA, 0);
-    analogWrite(leftmotor_pinB, leftmotor_speed);
+    analogWrite(leftmotor_pinB, leftDuty);
     analogWrite(rightmotor_pinA, 0);
-    analogWrite(rightmotor_pinB, rightmotor_speed);
+    analogWrite(rightmotor_pinB, rightDuty);
   } else {
     analogWrite(leftmotor_pinA, 0);
     analogWrite(leftmotor_pinB, 0);
@@ -662,6 +1186,53 @@ void driveMotors(byte motorState) {
   }
 }
 
+byte tiresRequiredForPole(byte pole) {
+    // The first pole and every pole that is further than 30cm from the previous pole requires 2 tires
+    byte required;
+    if (pole == 0 || currentOp.distanceOfPole[pole] - currentOp.distanceOfPole[pole - 1] >= ISOLATED_POLE_SPACING_MM) {
+        required = 2;
+    } else {
+        required = 1;
+    }
+
+    // Tires already on the pole count towards the tires it requires
+    if (currentOp.tiresOnPoleAfterOperation[pole] >= required) {
+        return 0;
+    }
+    return required - currentOp.tiresOnPoleAfterOperation[pole];
+}
+
+void planTireAllocation(byte numberOfPoles, byte tiresAvailable) {
+    // Plan the poles needing the fewest tires first (in driving order for ties), which completes the most
+    // poles for the tires available. A pole is only planned if it can be completed.
+    for (byte pole = 0; pole < numberOfPoles; pole++) {
+        tirePlan[pole] = 0;
+    }
+
+    for (byte need = 1; need <= 2; need++) {
+        for (byte pole = 0; pole < numberOfPoles; pole++) {
+            if (tiresRequiredForPole(pole) == need && need <= tiresAvailable) {
+                tirePlan[pole] = need;
+                tiresAvailable -= need;
+            }
+        }
+    }
+}
+
+void approachNextPole(void) {
+    // Poles are deployed on in reverse order on the way back, skipping poles without planned tires
+    while (currentPole > 0) {
+        currentPole--;
+        if (tirePlan[currentPole] > 0) {
+            setState(APPROACHING);
+            return;
+        }
+    }
+
+    // Every planned pole has been deployed on
+    setState(RETURNING);
+}
+
 byte decryptPState(byte pstate) {
     if (pstate == PS_0T || pstate == PS_1T || pstate == PS_2T) {
         return pstate;
@@ -672,17 +1243,52 @@ byte decryptPState(byte pstate) {
     }
 }
 
-// void initializeEncoder(void) {
-//     pinMode(encoder_master_pinB, INPUT);
-//     pinMode(encoder_slave_pinB, INPUT);
-//     attachInterrupt(digitalPinToInterrupt(encoder_master_pinB), masterWheelSpeed, CHANGE);
-//     attachInterrupt(digitalPinToInterrupt(encoder_slave_pinB), slaveWheelSpeed, CHANGE);
-// }
+void initializeEncoder(void) {
+    pinMode(encoder_master_pinB, INPUT);
+    pinMode(encoder_slave_pinB, INPUT);
+    attachInterrupt(digitalPinToInterrupt(encoder_master_pinB), masterEncoderTick, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(encoder_slave_pinB), slaveEncoderTick, CHANGE);
+}
+
+void masterEncoderTick(void) {
+    // Channel A leads channel B when driving forward, so A has already reached B's new level on every B edge
+    if (digitalRead(encoder_master_pinA) == digitalRead(encoder_master_pinB)) {
+        masterEncoderTicks++;
+    } else {
+        masterEncoderTicks--;
+    }
+}
 
-// void masterWheelSpeed(void) {
-//     driveMotors(OFF);
-// }
+void slaveEncoderTick(void) {
+    // The slave encoder is mounted mirrored, so channel B leads channel A when driving forward
+    if (digitalRead(encoder_slave_pinA) == digitalRead(encoder_slave_pinB)) {
+        slaveEncoderTicks--;
+    } else {
+        slaveEncoderTicks++;
+    }
+}
 
-// void slaveWheelSpeed(void) {
-//     driveMotors(OFF);
-// }
+void resetOdometry(void) {
+    noInterrupts();
+    masterEncoderTicks = 0;
+    slaveEncoderTicks = 0;
+    interrupts();
+
+    currentOp.position_in_mm = 0;
+    trimCorrection = 0;
+}
+
+void updateOdometry(void) {
+    // Copy the tick count atomically (a long takes several instructions to read)
+    noInterrupts();
+    long ticks = masterEncoderTicks;
+    interrupts();
+
+    // Convert ticks to millimetres, never reporting a position behind the start
+    long positionMM = (ticks * MM_PER_TICK_Q8) >> 8;
+    if (positionMM < 0) {
+        currentOp.position_in_mm = 0;
+    } else {
+        currentOp.position_in_mm = (unsigned short)positionMM;
+    }
+}
@@ -6,7 +6,36 @@
 /********************************* Includes **********************************/
 #include "I2C.h"
 #include "lcd.h"
+#include "timer.h"
 #include <stdio.h>
+
+/********************************** Types ************************************/
+// Step of the transfer in progress, named after the bus operation the next SSPIF completes
+typedef enum {
+    I2C_IDLE = 0,
+    I2C_START,
+    I2C_SEND_WRITE_ADDRESS,
+    I2C_SEND_REGISTER,
+    I2C_WRITE_DATA,
+    I2C_RESTART,
+    I2C_SEND_READ_ADDRESS,
+    I2C_READ_DATA,
+    I2C_SEND_ACK,
+    I2C_STOP
+} I2CState;
+
+/******************************** Variables **********************************/
+// Transfers are submitted at the head, run from the tail, and the slots stay in use until their
+// callback has run so the buffers and results can still be read
+static I2CTransfer i2cQueue[I2C_QUEUE_SIZE];
+static unsigned char i2cHead = 0;               // Slot the next transfer is submitted to
+static volatile unsigned char i2cTail = 0;      // Slot of the transfer running on the bus
+static unsigned char i2cUnfinished = 0;         // Oldest slot whose callback has not run
+
+static volatile I2CState i2cState = I2C_IDLE;
+static unsigned char i2cIndex;                  // Bytes of the running transfer done so far
+static SoftTimer i2cTimer;                      // Bounds how long the running transfer may hold the bus
+
 /***************************** Private Functions *****************************/
 /**
  * @brief Private function used to poll the MSSP module status. This function
@@ -24,6 +53,78 @@ static inline void I2C_Master_Wait(){
     }
 }
 
+/**
+ * @brief Private function that starts the transfer at the tail of the queue
+ * @param fromISR true when called from the interrupt handler, which must not
+ *        use Timer_Millis to start the timeout
+ */
+static void I2C_Start_Next(bool fromISR){
+    i2cIndex = 0;
+    i2cState = I2C_START;
+    if (fromISR) {
+        SoftTimer_StartISR(&i2cTimer, I2C_TIMEOUT_MS);
+    } else {
+        SoftTimer_Start(&i2cTimer, I2C_TIMEOUT_MS);
+    }
+    SSPCON2bits.SEN = 1;
+}
+
+/** @brief Private function that ends the running transfer with a Stop condition */
+static void I2C_Finish(unsigned char result){
+    i2cQueue[i2cTail].result = result;
+    i2cState = I2C_STOP;
+    SSPCON2bits.PEN = 1;
+}
+
+/** @brief Private function that frees the bus for the next transfer in the queue */
+static void I2C_Advance(bool fromISR){
+    i2cTail = (i2cTail + 1) & (I2C_QUEUE_SIZE - 1);
+
+    if (i2cTail != i2cHead) {
+        I2C_Start_Next(fromISR);
+    } else {
+        SoftTimer_Stop(&i2cTimer);
+        i2cState = I2C_IDLE;
+    }
+}
+
+/**
+ * @brief Private function that gives up on the running transfer. The MSSP
+ *        module is reset to release the bus, since a collided or stuck
+ *        transfer cannot be relied on to raise SSPIF again
+ */
+static void I2C_Abort(void){
+    i2cQueue[i2cTail].result = UNSUCCESSFUL;
+
+    SSPCON1bits.SSPEN = 0;
+    SSPCON2 = 0b00000000;
+    SSPIF = 0;
+    BCLIF = 0;
+    SSPCON1bits.SSPEN = 1;
+}
+
+/** @brief Private function that drops the running transfer once it has held the bus too long */
+static void I2C_Check_Timeout(void){
+    // Mask the interrupt so the engine cannot move on to another transfer while it is checked
+    SSPIE = 0;
+    if (i2cState != I2C_IDLE && SoftTimer_Expired(&i2cTimer)) {
+        I2C_Abort();
+        I2C_Advance(false);
+    }
+    SSPIE = 1;
+}
+
+/**
+ * @brief Private function used by the blocking functions to wait for the
+ *        background transfers to leave the bus. Each transfer is given at
+ *        most I2C_TIMEOUT_MS, so the wait is bounded by the queue length
+ */
+static inline void I2C_Wait_For_Engine(void){
+    while (i2cState != I2C_IDLE){
+        I2C_Check_Timeout();
+    }
+}
+
 /***************************** Public Functions ******************************/
 void I2C_Master_Init(const unsigned long clockFreq){
     // Disable the MSSP module
@@ -46,9 +147,20 @@ void I2C_Master_Init(const unsigned long clockFreq){
 
     // Set entire I2C operation to idle
     SSPCON2 = 0b00000000;
+
+    // Enable the MSSP interrupt (low priority) that drives the background transfers
+    SSPIF = 0;
+    SSPIP = 0;
+    SSPIE = 1;
+
+    // Enable the bus collision interrupt (low priority) so a collided transfer is dropped
+    BCLIF = 0;
+    BCLIP = 0;
+    BCLIE = 1;
 }
 
 void I2C_Master_Start(void){   
+    I2C_Wait_For_Engine(); // Let the background transfers finish
     I2C_Master_Wait(); // Ensure I2C module is idle
     SSPCON2bits.SEN = 1; // Initiate Start condition
 }
@@ -135,4 +247,138 @@ void rtcSetTime(char timeToInitialize[]) {
     }
     
     I2C_Master_Stop(); //Stop condition
-}
\ No newline at end of file
+}
+
+unsigned char I2C_Submit(const I2CTransfer *transfer) {
+    unsigned char next = (i2cHead + 1) & (I2C_QUEUE_SIZE - 1);
+    if (next == i2cUnfinished) {
+        return UNSUCCESSFUL;
+    }
+
+    i2cQueue[i2cHead] = *transfer;
+
+    // Mask the interrupt so the engine cannot finish a transfer between the checks below
+    SSPIE = 0;
+    i2cHead = next;
+    if (i2cState == I2C_IDLE) {
+        I2C_Start_Next(false);
+    }
+    SSPIE = 1;
+
+    return SUCCESSFUL;
+}
+
+void I2C_Service(void) {
+    I2C_Check_Timeout();
+
+    // A timed out transfer posts no event, so its callback is run from here
+    I2C_Complete();
+}
+
+void I2C_Complete(void) {
+    // Every slot before the running one has finished, so catch up on all of them in case an event was dropped
+    while (i2cUnfinished != i2cTail) {
+        if (i2cQueue[i2cUnfinished].callback != NULL) {
+            i2cQueue[i2cUnfinished].callback(&i2cQueue[i2cUnfinished]);
+        }
+        i2cUnfinished = (i2cUnfinished + 1) & (I2C_QUEUE_SIZE - 1);
+    }
+}
+
+// A collision leaves the transfer without another SSPIF, so it is dropped here
+void I2C_CollisionISR(void) {
+    BCLIF = 0;
+
+    // A blocking function is using the bus
+    if (i2cState == I2C_IDLE) {
+        return;
+    }
+
+    I2C_Abort();
+    Event_Post(EV_I2C_DONE, i2cTail);
+    I2C_Advance(true);
+}
+
+// Each bus operation raises SSPIF once it is done, which starts the next one
+void I2C_ISR(void) {
+    SSPIF = 0;
+
+    I2CTransfer *transfer = &i2cQueue[i2cTail];
+
+    switch (i2cState) {
+        case I2C_START:
+            i2cState = I2C_SEND_WRITE_ADDRESS;
+            SSPBUF = (unsigned char)(transfer->address << 1); // Address + Write
+            break;
+
+        case I2C_SEND_WRITE_ADDRESS:
+            if (SSPCON2bits.ACKSTAT) {
+                I2C_Finish(UNSUCCESSFUL);
+                break;
+            }
+            i2cState = I2C_SEND_REGISTER;
+            SSPBUF = transfer->reg; // Set memory pointer
+            break;
+
+        case I2C_SEND_REGISTER:
+        case I2C_WRITE_DATA:
+            if (SSPCON2bits.ACKSTAT) {
+                I2C_Finish(UNSUCCESSFUL);
+            } else if (transfer->read) {
+                i2cState = I2C_RESTART;
+                SSPCON2bits.RSEN = 1;
+            } else if (i2cIndex < transfer->length) {
+                i2cState = I2C_WRITE_DATA;
+                SSPBUF = transfer->buffer[i2cIndex++];
+            } else {
+                I2C_Finish(SUCCESSFUL);
+            }
+            break;
+
+        case I2C_RESTART:
+            i2cState = I2C_SEND_READ_ADDRESS;
+            SSPBUF = (unsigned char)((transfer->address << 1) | 1); // Address + Read
+            break;
+
+        case I2C_SEND_READ_ADDRESS:
+            if (SSPCON2bits.ACKSTAT) {
+                I2C_Finish(UNSUCCESSFUL);
+                break;
+            }
+            i2cState = I2C_READ_DATA;
+            SSPCON2bits.RCEN = 1;
+            break;
+
+        case I2C_READ_DATA:
+            // Acknowledge every byte except the last one
+            transfer->buffer[i2cIndex++] = SSPBUF;
+            i2cState = I2C_SEND_ACK;
+            SSPCON2bits.ACKDT = (i2cIndex < transfer->length) ? ACK : NACK;
+            SSPCON2bits.ACKEN = 1;
+            break;
+
+        case I2C_SEND_ACK:
+            if (i2cIndex < transfer->length) {
+                i2cState = I2C_READ_DATA;
+                SSPCON2bits.RCEN = 1;
+            } else {
+                I2C_Finish(SUCCESSFUL);
+            }
+            break;
+
+        case I2C_STOP:
+            // Hand the transfer to the main loop, then start the next one
+            Event_Post(EV_I2C_DONE, i2cTail);
+            I2C_Advance(true);
+            break;
+
+        default:
+            // A blocking function is using the bus
+            break;
+    }
+}
+
+unsigned char readTimeAsync(unsigned char pTime[], void (*callback)(I2CTransfer *transfer)) {
+    I2CTransfer transfer = {RTC_ADDRESS, 0x00, 7, pTime, true, callback, UNSUCCESSFUL};
+    return I2C_Submit(&transfer);
+}
@@ -8,13 +8,35 @@
 
 /********************************* Includes **********************************/
 #include <xc.h>
+#include <stdbool.h>
 #include "configureBits.h"
+#include "events.h"
 /********************************** Macros ***********************************/
 // These mean different things depending on the context, see "Understanding the
 // I2C bus" by Texas Instruments for more details
 #define ACK  0 /**< Acknowledge     */
 #define NACK 1 /**< Not acknowledge */
 
+#define I2C_QUEUE_SIZE 4    /**< Transfers that can wait for the bus, must be a power of 2 */
+#define RTC_ADDRESS 0x68    /**< 7 bit address of the DS1307 real time clock */
+#define I2C_TIMEOUT_MS 20   /**< Longest a background transfer may hold the bus before it is dropped */
+
+/********************************** Types ************************************/
+/**
+ * @brief A register read or write run in the background by the I2C engine.
+ *        The buffer must stay valid until the callback has run
+ */
+typedef struct I2CTransfer {
+    unsigned char address;      /**< 7 bit device address */
+    unsigned char reg;          /**< Register the transfer starts at */
+    unsigned char length;       /**< Number of bytes to read or write */
+    unsigned char *buffer;      /**< Bytes to write, or where read bytes go */
+    bool read;                  /**< true to read from the device, false to write */
+    void (*callback)(struct I2CTransfer *transfer); /**< Called from the main loop once done (optional) */
+    unsigned char result;       /**< SUCCESSFUL, or UNSUCCESSFUL if the device did not acknowledge,
+                                     the bus collided or the transfer timed out */
+} I2CTransfer;
+
 /************************ Public Function Prototypes *************************/
 /**
  * @brief Initializes the MSSP module for I2C mode. All configuration register
@@ -65,6 +87,38 @@ void condensedReadTime(unsigned char pTime[]);
 
 void rtcSetTime(char timeToInitialize[]);
 
+/**
+ * @brief Queues a transfer to run in the background. The transfer is copied,
+ *        and an EV_I2C_DONE event is posted once it completes
+ * @return SUCCESSFUL, or UNSUCCESSFUL if the queue is full
+ */
+unsigned char I2C_Submit(const I2CTransfer *transfer);
+
+/**
+ * @brief Runs the callbacks of the completed transfers and frees their slots.
+ *        Called by the main loop on an EV_I2C_DONE event
+ */
+void I2C_Complete(void);
+
+/**
+ * @brief Drops a background transfer that has held the bus for longer than
+ *        I2C_TIMEOUT_MS, and runs the callbacks of the finished transfers.
+ *        Called by the main loop on every EV_TICK event
+ */
+void I2C_Service(void);
+
+/** @brief Advances the transfer in progress, called on every SSPIF interrupt */
+void I2C_ISR(void);
+
+/** @brief Drops the transfer in progress, called on a BCLIF bus collision interrupt */
+void I2C_CollisionISR(void);
+
+/**
+ * @brief Queues a background read of the 7 RTC time registers into pTime
+ * @return SUCCESSFUL, or UNSUCCESSFUL if the queue is full
+ */
+unsigned char readTimeAsync(unsigned char pTime[], void (*callback)(I2CTransfer *transfer));
+
 /**
  * @}
  */
@@ -0,0 +1,56 @@
+/**
+ * events.c
+ */
+
+#include "events.h"
+#include "timer.h"
+
+// Events are only posted from the interrupt handler and only taken by the main loop, so the queue
+// needs no locking: the head is only written when posting and the tail only when taking
+static volatile Event eventQueue[EVENT_QUEUE_SIZE];
+static volatile unsigned char eventHead = 0;    // Index the next event is posted to
+static volatile unsigned char eventTail = 0;    // Index of the oldest event
+
+// Posts a timestamped event to the queue (interrupt handler only), dropping it if the queue is full
+unsigned char Event_Post(unsigned char type, unsigned char data) {
+    unsigned char next = (eventHead + 1) & (EVENT_QUEUE_SIZE - 1);
+    if (next == eventTail) {
+        return UNSUCCESSFUL;
+    }
+
+    // While the main loop is blocked the periodic events would pile up, so keep the rest of the queue for
+    // key presses. Nothing is lost by dropping them, the timer and the cached time advance in the interrupts
+    if ((type == EV_TICK || type == EV_RTC_SECOND) && ((eventHead - eventTail) & (EVENT_QUEUE_SIZE - 1)) >= EVENT_TICK_LIMIT) {
+        return UNSUCCESSFUL;
+    }
+
+    eventQueue[eventHead].type = type;
+    eventQueue[eventHead].data = data;
+#ifdef PROBES_ENABLED
+    eventQueue[eventHead].time = Timer_MillisISR();
+#endif
+    eventHead = next;
+
+    return SUCCESSFUL;
+}
+
+// Takes the oldest event from the queue (main loop only)
+unsigned char Event_Get(Event *event) {
+    if (eventTail == eventHead) {
+        return UNSUCCESSFUL;
+    }
+
+    event->type = eventQueue[eventTail].type;
+    event->data = eventQueue[eventTail].data;
+#ifdef PROBES_ENABLED
+    event->time = eventQueue[eventTail].time;
+#endif
+    eventTail = (eventTail + 1) & (EVENT_QUEUE_SIZE - 1);
+
+    return SUCCESSFUL;
+}
+
+// Whether the next post would be dropped, so the interrupt handler can leave data in its hardware buffer
+bool Event_QueueFull(void) {
+    return ((eventHead + 1) & (EVENT_QUEUE_SIZE - 1)) == eventTail;
+}
@@ -0,0 +1,40 @@
+/**
+ * events.h
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+/********************************* Includes **********************************/
+#include <xc.h>
+#include <stdbool.h>
+#include "configureBits.h"
+
+/********************************** Macros ***********************************/
+#define EVENT_QUEUE_SIZE 16     // Must be a power of 2
+#define EVENT_TICK_LIMIT (EVENT_QUEUE_SIZE / 2)     // Ticks and RTC seconds are dropped past this many queued events
+
+/********************************** Types ************************************/
+typedef enum {
+    EV_NONE = 0,
+    EV_KEY,         // A key was pressed (data: the key)
+    EV_TICK,        // TICK_EVENT_MS passed (data: unused)
+    EV_UART_RX,     // A message code was received from the Arduino (data: the code)
+    EV_ESTOP,       // The emergency stop was pressed (data: unused, raised by the main loop, not queued)
+    EV_I2C_DONE,    // A background I2C transfer completed (data: its I2C queue slot, see I2C_Complete)
+    EV_RTC_SECOND   // The RTC square wave ticked over a second (data: unused)
+} EventType;
+
+typedef struct Event {
+    unsigned char type;
+    unsigned char data;
+#ifdef PROBES_ENABLED
+    unsigned long time;     // Time (ms) the event was posted, read by the queue wait probe
+#endif
+} Event;
+
+/************************ Public Function Prototypes *************************/
+unsigned char Event_Post(unsigned char type, unsigned char data);
+unsigned char Event_Get(Event *event);
+bool Event_QueueFull(void);
+#endif /* EVENTS_H */
@@ -5,6 +5,7 @@
 
 /********************************* Includes **********************************/
 #include "lcd.h"
+#include "probe.h"
 
 /******************************** Constants **********************************/
 const unsigned char LCD_SIZE_HORZ = 16;
@@ -31,22 +32,54 @@ const char * months[] = {"ERR. ",
                          "Dec. "};
 
 static const char * dateSuffix[] = {"th", "st", "nd", "rd"};
+
+// Lookup tables for displayTime, kept in program memory
+#define BCD_HIGH_CHAR(bcd) ('0' + ((bcd) >> 4))     // Tens digit of a BCD value as a character
+#define BCD_LOW_CHAR(bcd) ('0' + ((bcd) & 0x0F))    // Ones digit of a BCD value as a character
+
+// Binary value of each BCD value up to 0x59 (invalid codes read as 0)
+static const unsigned char bcdToBinary[0x60] = {
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 0, 0, 0, 0, 0, 0,
+    10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 0, 0, 0, 0, 0, 0,
+    20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 0, 0, 0, 0, 0, 0,
+    30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 0, 0, 0, 0, 0, 0,
+    40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 0, 0, 0, 0, 0, 0,
+    50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 0, 0, 0, 0, 0, 0
+};
+
+// 12 hour clock digits and A/P for each hour of the 24 hour clock
+static const char hour12[24][3] = {
+    {'1', '2', 'A'}, {'0', '1', 'A'}, {'0', '2', 'A'}, {'0', '3', 'A'}, {'0', '4', 'A'}, {'0', '5', 'A'},
+    {'0', '6', 'A'}, {'0', '7', 'A'}, {'0', '8', 'A'}, {'0', '9', 'A'}, {'1', '0', 'A'}, {'1', '1', 'A'},
+    {'1', '2', 'P'}, {'0', '1', 'P'}, {'0', '2', 'P'}, {'0', '3', 'P'}, {'0', '4', 'P'}, {'0', '5', 'P'},
+    {'0', '6', 'P'}, {'0', '7', 'P'}, {'0', '8', 'P'}, {'0', '9', 'P'}, {'1', '0', 'P'}, {'1', '1', 'P'}
+};
+
+// Index into dateSuffix for each day of the month (the 11th to 13th take "th")
+static const unsigned char daySuffixIndex[32] = {
+    0, 1, 2, 3, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 2, 3, 0, 0, 0, 0, 0, 0,
+    0, 1
+};
 /***************************** Private Functions *****************************/
 /**
  * @brief Pulses the LCD register enable signal, which causes the LCD to latch
- *        the data on LATD. Interrupts are disabled during this pulse to
- *        guarantee that the timing requirements of the LCD's protocol are met
+ *        the data on LATD. Low-priority interrupts are disabled during this
+ *        pulse to guarantee that the timing requirements of the LCD's protocol
+ *        are met. The high-priority (emergency stop) interrupt stays enabled:
+ *        it only lengthens the pulse, which the LCD tolerates
  */
 static inline void pulse_e(void){
-    unsigned char interruptState = INTCONbits.GIE;
-    di();
+    unsigned char interruptState = INTCONbits.GIEL;
+    INTCONbits.GIEL = 0;
     E = 1;
     // This first delay only needs to be 1 microsecond in theory, but 25 was
     // selected experimentally to be safe
     __delay_us(25);
     E = 0;
     __delay_us(100);
-    INTCONbits.GIE = interruptState;
+    INTCONbits.GIEL = interruptState;
 }
 
 /**
@@ -116,9 +149,20 @@ void putch(char data){
     send_byte((unsigned char)data);
 }
 
+/**
+ * @brief Writes characters to the display at the cursor, without going
+ *        through printf
+ */
+static void write_chars(const char *text, unsigned char length){
+    for(unsigned char i = 0; i < length; i++){
+        putch(text[i]);
+    }
+}
+
 // Display functions
 void displayPage(char line1[], char line2[], char line3[], char line4[]) {
     // Displays text on the LCD screen
+    PROBE_BEGIN(PROBE_DISPLAY_PAGE);
 
     // Clear LCD and reset cursor
     lcd_clear();
@@ -132,6 +176,8 @@ void displayPage(char line1[], char line2[], char line3[], char line4[]) {
     printf(line3);
     lcd_set_ddram_addr(LCD_LINE4_ADDR);
     printf(line4);
+
+    PROBE_END(PROBE_DISPLAY_PAGE);
 }
 
 void displayMenuPage(char line1[], char line2[], char line3[], bool leftPage, bool rightPage) {
@@ -160,49 +206,64 @@ void displayMenuPage(char line1[], char line2[], char line3[], bool leftPage, bo
 }
 
 void displayTime(unsigned char time[]) {
-    
-    // Convert time to decimal from 1-12
-    if (time[5] > 0x09) {
-        time[5] = time[5] - 6;
+    // Builds both lines from the BCD time registers with table lookups, then writes them out directly
+    char line[16];
+    unsigned char month = bcdToBinary[time[5] & 0x1F];
+    unsigned char day = bcdToBinary[time[4] & 0x3F];
+    unsigned char hour = bcdToBinary[time[2] & 0x3F];
+    const char *text;
+
+    // Out of range registers display as month "ERR.", the 0th and 12 AM
+    if (month > 12) {
+        month = 0;
     }
-    
-    lcd_set_ddram_addr(LCD_LINE2_ADDR);
-    printf("%s ", months[time[5]]);     // Month
-    printf("%02X", time[4]);            // Date
-    if ((time[4] & 0x0F) <= 3) {        // Date Suffix
-        printf("%s", dateSuffix[(time[4] & 0x0F)]);
-    } else {
-        printf("th");
+    if (day > 31) {
+        day = 0;
     }
-    printf(", 20%02X", time[6]);        // Year
-    
-    lcd_set_ddram_addr(LCD_LINE3_ADDR); 
-    unsigned char hour;
-    // Getting the hour into 12 hour time
-
-    if (time[2] > 0x12) {
-        // Convert only if the hour is greater than 12
-        if ((time[2] & 0xF) < 0x2) {
-            // If the hour is 20 or 21
-            // The first digit will be 0, the second will be [10 - (2 - (secondHourDigit))]
-            hour = (0xA - (2 - (time[2] & 0xF)));
-        } else {
-            // If the hour has any second digit that is greater than 1 (13-19, 22-23)
-            // The first digit will reduce by 1, the second digit is reduced by 2
-            hour = (((time[2] >> 4) - 0x1) << 4) | ((time[2] & 0xF) - 0x2);
-        }
-    } else {
-        // If the hour is 12 or less, no need to convert to 12 hour time
-        hour = time[2];
+    if (hour > 23) {
+        hour = 0;
     }
-    
-    if (time[2] == 0x00) {
-        // If the hour is midnight, convert to 12 rather than 0
-        printf("   12:");   // Hour (12:00 AM)
-    } else {
-        printf("   %02X:", hour);   // Hour
+
+    // "Mmmm. DDss, 20YY"
+    text = months[month];
+    for (unsigned char i = 0; i < 5; i++) {
+        line[i] = text[i];
     }
-    printf("%02X:", time[1]);                       // Minute
-    printf("%02X ", time[0]);                       // Second
-    printf("%s  ", time[2] >= 0x12 ? "PM" : "AM");  // AM / PM
-}
\ No newline at end of file
+    line[5] = ' ';
+    line[6] = BCD_HIGH_CHAR(time[4]);
+    line[7] = BCD_LOW_CHAR(time[4]);
+    text = dateSuffix[daySuffixIndex[day]];
+    line[8] = text[0];
+    line[9] = text[1];
+    line[10] = ',';
+    line[11] = ' ';
+    line[12] = '2';
+    line[13] = '0';
+    line[14] = BCD_HIGH_CHAR(time[6]);
+    line[15] = BCD_LOW_CHAR(time[6]);
+
+    lcd_set_ddram_addr(LCD_LINE2_ADDR);
+    write_chars(line, 16);
+
+    // "   HH:MM:SS AM  "
+    text = hour12[hour];
+    line[0] = ' ';
+    line[1] = ' ';
+    line[2] = ' ';
+    line[3] = text[0];
+    line[4] = text[1];
+    line[5] = ':';
+    line[6] = BCD_HIGH_CHAR(time[1]);
+    line[7] = BCD_LOW_CHAR(time[1]);
+    line[8] = ':';
+    line[9] = BCD_HIGH_CHAR(time[0]);
+    line[10] = BCD_LOW_CHAR(time[0]);
+    line[11] = ' ';
+    line[12] = text[2];
+    line[13] = 'M';
+    line[14] = ' ';
+    line[15] = ' ';
+
+    lcd_set_ddram_addr(LCD_LINE3_ADDR);
+    write_chars(line, 16);
+}
@@ -5,6 +5,7 @@
 
 /********************************* Includes **********************************/
 #include "logs.h"
+#include "probe.h"
 
 /******************************** Constants **********************************/
 
@@ -73,7 +74,7 @@ unsigned char getSlotsAvailable(void) {
     return count;
 }
 
-unsigned char storeOperationIntoLogs(Operation op, unsigned char slotNumber) {
+static unsigned char storeOperation(Operation op, unsigned char slotNumber) {
     // Do not allow storage of logs past the maximum limit
     if (slotNumber >= MAX_LOGS) {
         return UNSUCCESSFUL;
@@ -140,6 +141,15 @@ unsigned char storeOperationIntoLogs(Operation op, unsigned char slotNumber) {
 
 }
 
+unsigned char storeOperationIntoLogs(Operation op, unsigned char slotNumber) {
+    // Time the whole store, whichever way it returns
+    PROBE_BEGIN(PROBE_STORE_LOG);
+    unsigned char result = storeOperation(op, slotNumber);
+    PROBE_END(PROBE_STORE_LOG);
+
+    return result;
+}
+
 unsigned char getOperationFromLogs(Operation *op, unsigned char slotNumber) {
     // If the log slot is out of range or there are no operations saved, return UNSUCCESSFUL
     unsigned char logSlotStatus = getLogSlot(slotNumber);
@@ -10,7 +10,12 @@
 #include "lcd.h"
 #include "I2C.h"
 #include "logs.h"
+#include "events.h"
 #include "operate.h"
+#include "power.h"
+#include "probe.h"
+#include "rtc.h"
+#include "timer.h"
 #include "uart.h"
 
 #include <stdio.h>
@@ -19,13 +24,16 @@
 //** MACROS **//
 #define MAX_TIRE_CAPACITY 15
 #define RETURN_TO_STANDBY_TIME_SECONDS 15
+#define KEY_REPEAT_DELAY_MS 500     // Time a key is held before it starts repeating
+#define KEY_REPEAT_PERIOD_MS 120    // Time between repeats of a held key
         
 #define PS_0T 0
 #define PS_1T 1
 #define PS_2T 2
 #define PS_None 3
 
-#define DEPLOYMENT_DURATION 9
+#define OP_MODE_SINGLE_PASS 0   // Deploy at each pole as it is found on the way out
+#define OP_MODE_TWO_PASS 1      // Map every pole on the way out, then deploy on the way back
 //** CONSTANTS **//
 
 // Constant values
@@ -48,10 +56,12 @@ typedef enum {
     ST_ERROR,
     ST_OPERATE_START,
     ST_OPERATE_DRIVING,
+    ST_OPERATE_MAPPING,
     ST_OPERATE_POLE_DETECTED,
     ST_OPERATE_DEPLOYING_TIRE,
     ST_OPERATE_RETURN,
-    ST_COMPLETED_OP
+    ST_COMPLETED_OP,
+    ST_COUNT
 } Status;
 
 typedef enum {
@@ -101,7 +111,9 @@ typedef enum {
     SC_SEND_ARDUINO_MESSAGE_ERROR,
     SC_UART_READ_TIMEOUT_ERROR,
     SC_SENSOR_TIMEOUT_ERROR,
+    SC_EMERGENCY_STOP_ERROR,
 
+    SC_COUNT    // Number of screens
 } Screen;
 
 typedef enum {
@@ -122,6 +134,8 @@ typedef enum {
     MSG_P2A_REQUEST_INITIALIZE_SENSOR,
     MSG_P2A_REQUEST_STATUS_SENSORS,
     MSG_P2A_ADJUSTMENT_COMPLETE,
+    MSG_P2A_CALIBRATE_TRIM,
+    MSG_P2A_PROBE_DUMP,
     
     // Arduino to PIC Messages
     MSG_A2P_SUCCESS = 100,
@@ -134,9 +148,23 @@ typedef enum {
     MSG_A2P_SENSOR_TIMEOUT,
     MSG_A2P_ADJUST_TOWARDS,
     MSG_A2P_ADJUST_AWAY,
+    MSG_A2P_ALIGNED,
+    MSG_A2P_MAPPING,
+    MSG_A2P_PREPARE_DEPLOY,
+    MSG_A2P_UART_READ_TIMEOUT,
+    MSG_A2P_ALIGN_TIMEOUT,
 
 } MSG_CODE;
 
+// Describes a screen: how it is drawn, how it handles events and whether it times out
+typedef struct ScreenDescriptor {
+    void (*render)(void);                   // Draws the screen when it is set or refreshed
+    void (*onKey)(unsigned char key);       // Handles key presses (optional)
+    void (*onEvent)(Event *event);          // Handles every other event (optional)
+    unsigned short timeoutSeconds;          // Time left idle before leaving the screen (0 for never)
+    Status timeoutStatus;                   // Status to set once the screen times out
+} ScreenDescriptor;
+
 //** VARIABLES **//
 
 // State variables
@@ -150,11 +178,13 @@ bool successfullyInitialized;   // Keeps track of initialization
 bool completedInitialization;   // Records the completion of initialization
 
 // Interrupt Variables
-volatile bool key_was_pressed = false;              // Keeps track of whether keypad input was pressed
 volatile bool emergency_stop_pressed = false;       // Keeps track of whether emergency stop was pressed
-volatile bool receivedMessageFromArduino = false;   // Keeps track of whether a message was received from arduino
-volatile unsigned char key;                         // Contains the key pressed from the keypad
+volatile bool emergencyStopPending = false;         // Emergency stop still to be reported to the Arduino and screen
 unsigned char messageFromArduino;                   // Contains the message received from arduino
+unsigned char deployMisalignment = 0;               // Alignment error (mm) reported for the tire being deployed
+volatile bool uartReceiveDeferred = false;          // A message code is waiting in the UART for a free event slot
+volatile unsigned char heldKey = 0;                 // Key being auto-repeated while held (0 for none)
+volatile unsigned short heldKeyTime = 0;            // Time (ms) until the held key repeats
 
 // RTC Variables
 char valueToWriteToRTC[7] = {               // The time to initialize to if writing to RTC
@@ -168,16 +198,16 @@ char valueToWriteToRTC[7] = {               // The time to initialize to if writ
 };
 
 // Timer variables
-unsigned short returnToStandbyTick = 0;     // Timer variable (milliseconds) for returning to standby mode
-unsigned char returnToStandbyCounter = 0;   // Timer variable (seconds) for returning to standby mode
+SoftTimer screenTimer;              // Timer for leaving a screen that has a timeout
+unsigned long operationStartTime = 0;   // Time (ms) the current operation started
 
-unsigned char clockTick = 0;    // Time variable (milliseconds) for displaying time
-unsigned short durationTick = 0;
-unsigned short durationSeconds = 0;
+// Operation variables
+unsigned char loadedTires = MAX_TIRE_CAPACITY;  // Number of tires selected on the load tires screen
 
 // Other variables
 unsigned char pstates[10];
 bool debugMode = false;
+bool twoPassOperation = false;  // Map every pole before deploying on the way back
 bool receivingData = false;
 //** PROTOTYPES **//
 
@@ -189,1338 +219,208 @@ Screen getScreen(void);
 void setScreen(Screen newScreen);
 void refreshScreen(void);
 void cyclePState(unsigned char pNum);
+void dispatchEvent(Event *event);
+void repeatHeldKey(void);
+void activateEmergencyStop(void);
+void finishOperation(void);
+
+// Status Functions
+void enterStandby(void);
+void enterReady(void);
+void enterError(void);
+void enterOperateStart(void);
+void enterOperating(void);
+void enterDeployingTire(void);
+void enterCompletedOp(void);
+
+// Screen Functions
+void renderStandby(void);
+void keyStandby(unsigned char key);
+void eventStandby(Event *event);
+void renderMenu(void);
+void keyMenu(unsigned char key);
+void renderAbout(void);
+void keyAbout(unsigned char key);
+void renderDebug(void);
+void keyDebug(unsigned char key);
+void renderDebugLog(void);
+void keyDebugLog(unsigned char key);
+void renderDebugMotor(void);
+void keyDebugMotor(unsigned char key);
+void renderDebugStepper(void);
+void keyDebugStepper(unsigned char key);
+void renderDebugSensor(void);
+void keyDebugSensor(unsigned char key);
+void renderDebugClock(void);
+void keyDebugClock(unsigned char key);
+void renderLogsMenu(void);
+void keyLogsMenu(unsigned char key);
+void renderLogsView(void);
+void keyLogsView(unsigned char key);
+void renderOperationDbg(void);
+void keyOperationDbg(unsigned char key);
+void renderOperationInit(void);
+void keyOperationInit(unsigned char key);
+void renderOperationSensorCheck(void);
+void keyOperationSensorCheck(unsigned char key);
+void renderLoadTires(void);
+void keyLoadTires(unsigned char key);
+void renderOperating(void);
+void keyOperating(unsigned char key);
+void eventOperating(Event *event);
+void renderTerminated(void);
+void keyTerminated(unsigned char key);
+void renderViewResults(void);
+void keyViewResults(unsigned char key);
+void renderSave(void);
+void keySave(unsigned char key);
+void renderSelectSaveSlot(void);
+void keySelectSaveSlot(unsigned char key);
+void renderOverwriteLogVerification1(void);
+void keyOverwriteLogVerification1(unsigned char key);
+void renderOverwriteLogVerification2(void);
+void keyOverwriteLogVerification2(unsigned char key);
+void renderOverwriteLogVerification3(void);
+void keyOverwriteLogVerification3(unsigned char key);
+void renderSaveCompleted(void);
+void keySaveCompleted(unsigned char key);
+void renderLogViewError(void);
+void keyLogViewError(unsigned char key);
+void renderInvalidStateError(void);
+void keyInvalidStateError(unsigned char key);
+void renderInvalidScreenError(void);
+void keyInvalidScreenError(unsigned char key);
+void renderSaveOperationError(void);
+void keySaveOperationError(unsigned char key);
+void renderUnhandledArduinoMessageError(void);
+void keyUnhandledArduinoMessageError(unsigned char key);
+void renderSendArduinoMessageError(void);
+void keySendArduinoMessageError(unsigned char key);
+void renderUartInitError(void);
+void keyUartInitError(unsigned char key);
+void renderUartReadTimeoutError(void);
+void keyUartReadTimeoutError(unsigned char key);
+void renderSensorTimeoutError(void);
+void keySensorTimeoutError(unsigned char key);
+void renderEmergencyStopError(void);
+void keyEmergencyStopError(unsigned char key);
+
+// Every screen, indexed by its Screen value. Kept const so the table stays in program memory
+const ScreenDescriptor screens[SC_COUNT] = {
+    [SC_STANDBY]                         = {renderStandby, keyStandby, eventStandby},
+    [SC_MENU]                            = {renderMenu, keyMenu, NULL, RETURN_TO_STANDBY_TIME_SECONDS, ST_STANDBY},
+    [SC_ABOUT]                           = {renderAbout, keyAbout},
+    [SC_DEBUG]                           = {renderDebug, keyDebug},
+    [SC_DEBUG_LOG]                       = {renderDebugLog, keyDebugLog},
+    [SC_DEBUG_MOTOR]                     = {renderDebugMotor, keyDebugMotor},
+    [SC_DEBUG_STEPPER]                   = {renderDebugStepper, keyDebugStepper},
+    [SC_DEBUG_SENSOR]                    = {renderDebugSensor, keyDebugSensor},
+    [SC_DEBUG_CLOCK]                     = {renderDebugClock, keyDebugClock},
+    [SC_LOGS_MENU]                       = {renderLogsMenu, keyLogsMenu},
+    [SC_LOGS_VIEW]                       = {renderLogsView, keyLogsView},
+    [SC_OPERATION_DBG]                   = {renderOperationDbg, keyOperationDbg},
+    [SC_OPERATION_INIT]                  = {renderOperationInit, keyOperationInit},
+    [SC_OPERATION_SENSOR_CHECK]          = {renderOperationSensorCheck, keyOperationSensorCheck},
+    [SC_LOAD_TIRES]                      = {renderLoadTires, keyLoadTires},
+    [SC_OPERATING]                       = {renderOperating, keyOperating, eventOperating},
+    [SC_TERMINATED]                      = {renderTerminated, keyTerminated},
+    [SC_VIEW_RESULTS]                    = {renderViewResults, keyViewResults},
+    [SC_SAVE]                            = {renderSave, keySave},
+    [SC_SELECT_SAVE_SLOT]                = {renderSelectSaveSlot, keySelectSaveSlot},
+    [SC_OVERWRITE_LOG_VERIFICATION_1]    = {renderOverwriteLogVerification1, keyOverwriteLogVerification1},
+    [SC_OVERWRITE_LOG_VERIFICATION_2]    = {renderOverwriteLogVerification2, keyOverwriteLogVerification2},
+    [SC_OVERWRITE_LOG_VERIFICATION_3]    = {renderOverwriteLogVerification3, keyOverwriteLogVerification3},
+    [SC_SAVE_COMPLETED]                  = {renderSaveCompleted, keySaveCompleted},
+    [SC_LOG_VIEW_ERROR]                  = {renderLogViewError, keyLogViewError},
+    [SC_INVALID_STATE_ERROR]             = {renderInvalidStateError, keyInvalidStateError},
+    [SC_INVALID_SCREEN_ERROR]            = {renderInvalidScreenError, keyInvalidScreenError},
+    [SC_SAVE_OPERATION_ERROR]            = {renderSaveOperationError, keySaveOperationError},
+    [SC_UNHANDLED_ARDUINO_MESSAGE_ERROR] = {renderUnhandledArduinoMessageError, keyUnhandledArduinoMessageError},
+    [SC_SEND_ARDUINO_MESSAGE_ERROR]      = {renderSendArduinoMessageError, keySendArduinoMessageError},
+    [SC_UART_INIT_ERROR]                 = {renderUartInitError, keyUartInitError},
+    [SC_UART_READ_TIMEOUT_ERROR]         = {renderUartReadTimeoutError, keyUartReadTimeoutError},
+    [SC_SENSOR_TIMEOUT_ERROR]            = {renderSensorTimeoutError, keySensorTimeoutError},
+    [SC_EMERGENCY_STOP_ERROR]            = {renderEmergencyStopError, keyEmergencyStopError}
+};
+
+// Initial function of every status, indexed by its Status value
+void (* const statusEntries[ST_COUNT])(void) = {
+    [ST_STANDBY]                         = enterStandby,
+    [ST_READY]                           = enterReady,
+    [ST_ERROR]                           = enterError,
+    [ST_OPERATE_START]                   = enterOperateStart,
+    [ST_OPERATE_DRIVING]                 = enterOperating,
+    [ST_OPERATE_MAPPING]                 = enterOperating,
+    [ST_OPERATE_POLE_DETECTED]           = enterOperating,
+    [ST_OPERATE_DEPLOYING_TIRE]          = enterDeployingTire,
+    [ST_OPERATE_RETURN]                  = enterOperating,
+    [ST_COMPLETED_OP]                    = enterCompletedOp
+};
 
 void main(void) {
     // Setup variables, pins and peripherals
     initialize();
-    
-    // Initialize other variables
-
-    // Time Variables
-    unsigned short tick = 0;
-    unsigned char counter = 0;
-    unsigned char time[7];
-
-    // Operation Variables
-    unsigned char loadedTires = 15;
-    unsigned short sensorReading;
 
-    // Other variables
-    unsigned char temporaryResult;
-    unsigned char temporaryByte;
+    Event event;
     
     // Main Loop
     while (1) {
+        // The interrupt has already cut the actuators, finish handling the emergency stop here
+        if (emergencyStopPending) {
+            emergencyStopPending = false;
+            activateEmergencyStop();
 
-        // Screen based actions
-        switch (getScreen()) {
-            //==============STATUS: STANDBY==============
-            case SC_STANDBY:
-                /* [Any Key] - Go into the main menu
-                 */
-                if (key_was_pressed) {
-                    // After any key press, go into the menu
-                    counter = 0;
-                    setStatus(ST_READY);
-                    
-                    key_was_pressed = false;
-                    
-                } else {
-                    // Read and display the time while on standby screen
-                    if (tick % 100 == 0) {
-                        readTime(time);
-                        displayTime(time);
-                    }
-                }
-
-                break;
-
-            //===============STATUS: READY===============
-            case SC_MENU:
-                /* [A] Load Tires
-                 * [B] Logs
-                 * [C] About
-                 * [D] Debug
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'A':
-                            setScreen(SC_OPERATION_INIT);
-                            break;
-                            
-                        case 'B':
-                            setScreen(SC_LOGS_MENU);
-                            break;
-                            
-                        case 'C':
-                            setScreen(SC_ABOUT);
-                            break;
-                            
-                        case 'D':
-                            setScreen(SC_DEBUG);
-                            break;
-
-                        case '7':
-                        for (unsigned char i = 0; i < 10; i++) {
-                            if (i < 4) {
-                                pstates[i] = PS_0T;
-                            } else {
-                                pstates[i] = PS_None;
-                            }
-                        }
-                            setScreen(SC_OPERATION_DBG);
-                            
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-
-                // Increment timer for returning to standby while in the main menu screen
-                returnToStandbyTick++;
-                if (returnToStandbyTick == 1000) {
-                    returnToStandbyTick = 0;
-
-                    returnToStandbyCounter++;
-
-                    if (returnToStandbyCounter == RETURN_TO_STANDBY_TIME_SECONDS) {
-                        // After RETURN_TO_STANDBY_TIME_SECONDS, return to Standby status
-                        returnToStandbyCounter = 0;
-                        setStatus(ST_STANDBY);
-                    }
-                }
-
-
-                break;
-            //===========================================
-            case SC_ABOUT:
-                /* [D] Back
-                */
-               if (key_was_pressed) {
-                   switch (key) {
-                        case 'D':
-                            setScreen(SC_MENU);
-                            break;
-
-                        default:
-                            break;
-                   }
-
-                   key_was_pressed = false;
-               }
-               break;
-            
-            //===========================================
-            case SC_DEBUG:
-                /* [A] Motor Debug
-                 * [B] Log Debug
-                 * [C] Sensor Debug
-                 * [D] Back
-                 */
-                
-                if (key_was_pressed) {
-                   switch (key) {
-                        case 'A':
-                            setScreen(SC_DEBUG_MOTOR);
-                            break;
-                       
-                        case 'B':
-                            setScreen(SC_DEBUG_LOG);
-                            break;
-
-                        case 'C':
-                            setScreen(SC_DEBUG_SENSOR);
-                            break;
-                           
-                        case 'D':
-                            setScreen(SC_MENU);
-                            break;
-
-                        case '1':
-                            setScreen(SC_DEBUG_CLOCK);
-                            break;
-
-                        default:
-                            break;
-                   }
-
-                   key_was_pressed = false;
-               }
-               break;
-
-            //===========================================
-            case SC_DEBUG_LOG:
-                /* [C] Reset Slots
-                 * [D] Back
-                 */
-                
-                if (key_was_pressed) {
-                   switch (key) {
-                        case 'C':
-//                            writeAllLogSlots(0x0000);
-                            refreshScreen();
-                            break;
-
-                        case 'D':
-                            setScreen(SC_DEBUG);
-                            break;
-
-                        default:
-                            break;
-                   }
-
-                   key_was_pressed = false;
-               }
-               break;
-
-            //===========================================
-            case SC_DEBUG_MOTOR:
-                /* [A] Forward
-                 * [B] Backward
-                 * [C] Off
-                 * [D] Back
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'A':
-                            // Tell Arduino to drive motors forward
-                            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_DRIVE_FORWARD, "DBG_DRIVE_FRWARD");
-                            break;
-
-                        case 'B':
-                            // Tell Arduino to drive motors backward
-                            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_DRIVE_BACKWARD, "DEBUG_DRIVE_BACK");
-                            break;
-
-                        case 'C':
-                            // Tell Arduino to stop driving motors
-                            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_STOP, "   DEBUG_STOP   ");
-                            break;
-
-                        case 'D':
-                            // Return and tell Arduino to stop driving
-                            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_STOP, "   DEBUG_STOP   ");
-                            setScreen(SC_DEBUG);
-                            break;
-
-                        case '1':
-                            setScreen(SC_DEBUG_STEPPER);
-                            break;
-                            
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-
-                break;
-
-            //===========================================
-            case SC_DEBUG_STEPPER:
-                /* [1] 1 Forward
-                 * [3] 1 Back
-                 * [4] Tire Forward
-                 * [6] Tire Back
-                 * [0] Stop
-                 * [D] Return
-                 */
-                if (key_was_pressed) {
-                    switch (key) {                        
-                        case 'D':
-                            setScreen(SC_DEBUG);
-                            break;
-                            
-                        case '1':
-                            // Drive stepper 1 revolution forward
-                            driveStepper(1, FORWARD);
-                            break;
-                            
-                        case '3':
-                            // Drive stepper 1 revolution backward
-                            driveStepper(1, BACKWARD);
-                            break;
-                            
-                        case '0':
-                            STEPPER_EN = 0;
-                            STEPPER_DIR = 0;
-                            STEPPER_PULSE = 0;
-                            break;
-                            
-                        case '4':
-                            // Make enough revolutions to deploy a tire (forward)
-                            driveStepper(REVOLUTIONS_TO_DROP_ONE_TIRE, FORWARD);
-                            break;
-                            
-                        case '6':
-                            // Make enough revolutions for one tire (backward)
-                            driveStepper(REVOLUTIONS_TO_DROP_ONE_TIRE, BACKWARD);
-                            break;
-                            
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-                break;
-                
-            //===========================================
-            case SC_DEBUG_SENSOR:
-                /* [1] Initialize
-                 * [C] Read Sensor
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-
-                        case '1':
-                            // Print the first two lines of the screen
-                            lcd_home();
-                            printf("Starting sensor ");
-
-                            lcd_set_ddram_addr(LCD_LINE2_ADDR);
-                            printf("                ");
-
-                            // Request sensor initialization from the Arduino
-                            temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_INITIALIZE_SENSOR, &temporaryByte);
-
-                            // Throw an error if UART communication failed
-                            if (temporaryResult == UART_READ_TIMEOUT) {
-                                setStatus(ST_ERROR);
-                                setScreen(SC_UART_READ_TIMEOUT_ERROR);
-                                break;
-
-                            } else if (temporaryResult == UART_WRITE_TIMEOUT) {
-                                setStatus(ST_ERROR);
-                                setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
-
-                                lcd_set_ddram_addr(LCD_LINE3_ADDR);
-                                printf("RQST_INIT_SENSOR");
-                                break;
-                            } 
-                            
-                            // Display whether the initialization was a success or not
-                            lcd_set_ddram_addr(LCD_LINE2_ADDR);
-
-                            if (temporaryByte == MSG_A2P_SUCCESS) {
-                                printf("Successful start");
-
-                            } else if (temporaryByte == MSG_A2P_FAILED) {
-                                printf("Failed to start ");
-                            }
-
-                            break;
-
-
-                        case 'C':
-                            // Print first two lines of screen
-                            lcd_home();
-                            printf("Reading distance");
-                            lcd_set_ddram_addr(LCD_LINE2_ADDR);
-                            printf("                ");
-
-                            // Retrieve sensor data from Arduino
-                            temporaryResult = UART_Request_Short(MSG_P2A_DEBUG_SENSOR_BASE, &sensorReading);
-
-                            // Throw an error if the UART communication failed
-                            UART_Request_Error_Handling(temporaryResult, "DEBUG_SNSR_BASE ");
-
-                            // Write sensor data to LCD
-                            lcd_home();
-                            if (sensorReading) {
-                                printf("SNS_BASE:    %03d", sensorReading);
-                            } else {
-                                printf("SNS_BASE:   None");
-                            }
-
-                            if (debugMode) {
-                                // Display next sensor results on the second line
-                                lcd_set_ddram_addr(LCD_LINE2_ADDR);
-                                
-                                // Retrieve sensor data from Arduino
-                                temporaryResult = UART_Request_Short(MSG_P2A_DEBUG_SENSOR_TIRE1, &sensorReading);
-
-                                // Throw an error if the UART communication failed
-                                UART_Request_Error_Handling(temporaryResult, "DEBUG_SNSR_TIRE1");
-
-                                // Write sensor data to LCD
-                                if (sensorReading) {
-                                    printf("SNS_TIR1: %d", sensorReading);
-                                } else {
-                                    printf("SNS_TIR1:   None");
-                                }
-
-                                lcd_set_ddram_addr(LCD_LINE3_ADDR);
-
-                                // Retrieve sensor data from Arduino
-                                temporaryResult = UART_Request_Short(MSG_P2A_DEBUG_SENSOR_TIRE2, &sensorReading);
-
-                                // Throw an error if the UART communication failed
-                                UART_Request_Error_Handling(temporaryResult, "DEBUG_SNSR_TIRE2");
-
-                                // Write sensor data to LCD
-                                if (sensorReading) {
-                                    printf("SNS_TIR2: %d", sensorReading);
-                                } else {
-                                    printf("SNS_TIR2:   None");
-                                }
-                            }
-                            break;
-
-                        case 'D':
-                            setScreen(SC_DEBUG);
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-                
-                break;
-
-            //===========================================
-            case SC_DEBUG_CLOCK:
-                /* [C] Reset Time  
-                 * [D] Back
-                 */
-                
-                if (key_was_pressed) {
-                   switch (key) {
-                        case 'C':
-                            rtcSetTime(valueToWriteToRTC);
-
-                            // Display feedback message
-                            lcd_set_ddram_addr(LCD_LINE1_ADDR);
-                            printf(" Time Rewritten ");
-                            break;
-
-                        case 'D':
-                            setScreen(SC_DEBUG);
-                            break;
-
-                        default:
-                            break;
-                   }
-
-                   key_was_pressed = false;
-               }
-               break;
-
-            //===========================================
-            case SC_LOGS_MENU:
-                /* [A] View Logs
-                 * [B] Download
-                 * [D] Back
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'A':
-                            page = 0;
-                            setScreen(SC_LOGS_VIEW);
-                            break;
-
-                        case 'B':
-                            // to be implemented
-                            break;
-
-                        case 'D':
-                            setScreen(SC_MENU);
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-                break;
-
-            //===========================================
-            case SC_LOGS_VIEW:
-                /*
-                 * [A] Slot #<1, 4, 7, 10, 13, 16>
-                 * [B] Slot #<2, 5, 8, 11, 14>
-                 * [C] Slot #<3, 6, 9, 12, 15>
-                 * <[*] BCK[0] [#]>
-                */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case '*':
-                            // Go to the previous page
-                            if (page > 0) {
-                                page--;
-                                refreshScreen();
-                            }
-                            break;
-
-                        case '0':
-                            // Return to the logs menu
-                            setScreen(SC_LOGS_MENU);
-                            break;
-
-                        case '#':
-                            // Go to the next page
-                            if (page < (MAX_LOGS - 1) / 3) {
-                                page++;
-                                refreshScreen();
-                            }
-                            break;
-
-                        case 'A':
-                            // View operation from log slot A
-                            if (getLogSlot(page * 3) == SLOT_USED) {
-                                if (getOperationFromLogs(&CURRENT_OPERATION, (page * 3)) == SUCCESSFUL) {
-                                    page = 0;
-                                    setScreen(SC_VIEW_RESULTS);
-                                } else {
-                                    setStatus(ST_ERROR);
-                                    setScreen(SC_LOG_VIEW_ERROR);
-                                }
-                            }
-                            break;
-
-                        case 'B':
-                            // View operation from log slot B
-                            if (getLogSlot((page * 3) + 1) == SLOT_USED) {
-                                if (getOperationFromLogs(&CURRENT_OPERATION, ((page * 3) + 1)) == SUCCESSFUL) {
-                                    page = 0;
-                                    setScreen(SC_VIEW_RESULTS);
-                                } else {
-                                    setStatus(ST_ERROR);
-                                    setScreen(SC_LOG_VIEW_ERROR);
-                                }
-                            }
-                            break;
-
-                        case 'C':
-                            // View operation from log slot C
-                            if (getLogSlot((page * 3) + 2) == SLOT_USED) {
-                                if (getOperationFromLogs(&CURRENT_OPERATION, ((page * 3) + 2)) == SUCCESSFUL) {
-                                    page = 0;
-                                    setScreen(SC_VIEW_RESULTS);
-                                } else {
-                                    setStatus(ST_ERROR);
-                                    setScreen(SC_LOG_VIEW_ERROR);
-                                }
-                            }
-                            break;
-                            
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-
-                break;
-
-            //===========================================
-            case SC_OPERATION_DBG:
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            setScreen(SC_OPERATION_SENSOR_CHECK);
-                            break;
-
-                        case '1':
-                            cyclePState(0);
-                            refreshScreen();
-                            break;
-
-                        case '2':
-                            cyclePState(1);
-                            refreshScreen();
-                            break;
-
-                        case '3':
-                            cyclePState(2);
-                            refreshScreen();
-                            break;
-
-                        case '4':
-                            cyclePState(3);
-                            refreshScreen();
-                            break;
-
-                        case '5':
-                            cyclePState(4);
-                            refreshScreen();
-                            break;
-
-                        case '6':
-                            cyclePState(5);
-                            refreshScreen();
-                            break;
-
-                        case '7':
-                            cyclePState(6);
-                            refreshScreen();
-                            break;
-
-                        case '8':
-                            cyclePState(7);
-                            refreshScreen();
-                            break;
-
-                        case '9':
-                            cyclePState(8);
-                            refreshScreen();
-                            break;
-
-                        case '0':
-                            cyclePState(9);
-                            refreshScreen();
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-                break;
-
-            //===========================================
-            case SC_OPERATION_INIT:
-                /* SNSR_BASE:
-                 * SNSR_TIRE1:
-                 * SNSR_TIRE2:
-                 * [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Only allow action if initialization is complete
-                            if (completedInitialization) {
-                                // Take the user back to the main menu if the initialization failed
-                                if (successfullyInitialized) {
-                                    setScreen(SC_LOAD_TIRES);
-                                } else {
-                                    setScreen(SC_MENU);
-                                }
-                            }
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-                
-                break;
-
-            //===========================================
-            case SC_OPERATION_SENSOR_CHECK:
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Send signal to arduino to start with the parameters
-                            UART_Write_With_Error_Handle(MSG_P2A_OP_DEBUG, "     OP_DBG     ");
-
-                            for (unsigned char i = 0; i < 10; i++) {
-                                UART_Write_With_Error_Handle(pstates[i], "     PSTATE     ");
-                            }
-
-                            setStatus(ST_OPERATE_START);
-                            dbg = true;
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-                break;
-
-            //===========================================
-            case SC_LOAD_TIRES:
-                /* [*]Less  More[#]
-                 * [C] Start Op.
-                 * [D] Back
-                 */
-                lcd_set_ddram_addr(LCD_LINE1_ADDR);
-                printf("Loading %02d tires", loadedTires);
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case '#':
-                            // Increase the number of tires loaded
-                            if (loadedTires < MAX_TIRE_CAPACITY) {
-                                loadedTires++;
-                                refreshScreen();
-                            }
-                            
-                            break;
-                            
-                        case '*':
-                            // Decrease the number of tires loaded
-                            if (loadedTires > 0) {
-                                loadedTires--;
-                                refreshScreen();
-                            }
-                            
-                            break;
-                            
-                        case 'C':
-                            // Start the operation with desired amount of tires
-                            setStatus(ST_OPERATE_START);
-                            
-                            // Update the current operation with the number of tires remaining
-                            CURRENT_OPERATION.tiresRemaining = loadedTires;
-                            loadedTires = MAX_TIRE_CAPACITY;
-                            
-                            break;
-
-                        case 'D':
-                            setStatus(ST_READY);
-                            loadedTires = MAX_TIRE_CAPACITY;
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-
-                break;
-
-            //=============STATUS: OPERATING=============
-            case SC_OPERATING:
-                // If the emergency stop button is pressed, stop operating
-                if (emergency_stop_pressed) {
-                    setStatus(ST_COMPLETED_OP);
-                    break;
-                }
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            UART_Write_With_Error_Handle(MSG_P2A_STOP, "      STOP      ");
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                }
-
-                
-                // Listen for messages from the Arduino
-                if (UART_Data_Ready()) {
-                    while (receivingData) { continue; }
-                    receivingData = true;
-                    // If the reading timed out, throw an error
-                    if (UART_Read(&messageFromArduino) == UART_READ_TIMEOUT) {
-                        setStatus(ST_ERROR);
-                        setScreen(SC_UART_READ_TIMEOUT_ERROR);
-                        break;
-                    }
-
-                    switch (messageFromArduino) {
-
-                        case MSG_A2P_DRIVING:
-                        // Set the status of the robot to driving and refresh the screen
-                            setStatus(ST_OPERATE_DRIVING);
-                            refreshScreen();
-                            break;
-
-                        case MSG_A2P_RETURNING:
-                        // Set the status of the robot to returning and refresh the screen
-                            setStatus(ST_OPERATE_RETURN);
-                            refreshScreen();
-                            break;
-
-                        case MSG_A2P_POLE_DETECTED:
-                        // Set the status when a pole is detected
-                            setStatus(ST_OPERATE_POLE_DETECTED);
-                            break;
-
-                        case MSG_A2P_DEPLOY_STEPPER:
-                        // Set the status to deploying a tire
-                            setStatus(ST_OPERATE_DEPLOYING_TIRE);
-                            break;
-
-                        case MSG_A2P_COMPLETE_OP:
-                        // Complete the operation on the robot
-                            temporaryResult = UART_Read(&(CURRENT_OPERATION.totalSuppliedTires));
-                            UART_ErrorHandleRead(temporaryResult);
-
-                            temporaryResult = UART_Read(&(CURRENT_OPERATION.totalNumberOfPoles));
-                            UART_ErrorHandleRead(temporaryResult);
-
-                            for (unsigned char i = 0; i < 10; i++) {
-                                temporaryResult = UART_Read(&(CURRENT_OPERATION.tiresDeployedOnPole[i]));
-                                UART_ErrorHandleRead(temporaryResult);
-                            }
-
-                            for (unsigned char i = 0; i < 10; i++) {
-                                temporaryResult = UART_Read(&(CURRENT_OPERATION.tiresOnPoleAfterOperation[i]));
-                                UART_ErrorHandleRead(temporaryResult);
-                            }
-
-                            for (unsigned char i = 0; i < 10; i++) {
-                                temporaryResult = UART_Read_Short(&(CURRENT_OPERATION.distanceOfPole[i]));
-                                UART_ErrorHandleRead(temporaryResult);
-                            }
-
-                            setStatus(ST_COMPLETED_OP);
-                            break;
-
-                        case MSG_A2P_SENSOR_TIMEOUT:
-                        // Throw an error if the sensor times out
-                            setStatus(ST_ERROR);
-                            setScreen(SC_SENSOR_TIMEOUT_ERROR);
-                            break;
-
-                        case MSG_A2P_ADJUST_AWAY:
-                            driveMotors(MOTOR_AWAY);
-                            __delay_ms(15);
-                            driveMotors(MOTOR_OFF);
-                            UART_Write_With_Error_Handle(MSG_P2A_ADJUSTMENT_COMPLETE, "  ADJ_COMPLETE  ")
-                            break;
-
-                        case MSG_A2P_ADJUST_TOWARDS:
-                            driveMotors(MOTOR_TOWARDS);
-                            __delay_ms(15);
-                            driveMotors(MOTOR_OFF);
-                            UART_Write_With_Error_Handle(MSG_P2A_ADJUSTMENT_COMPLETE, "  ADJ_COMPLETE  ")
-                            break;
-
-                        default:
-                        // Invalid arduino message, throw error
-                            setStatus(ST_ERROR);
-                            setScreen(SC_UNHANDLED_ARDUINO_MESSAGE_ERROR);
-
-                            lcd_set_ddram_addr(LCD_LINE3_ADDR);
-                            printf("%X", messageFromArduino);
-                            break;
-                    }
-                    receivingData = false;
-                }
-
-                break;
-            
-            //=============STATUS: COMPLETED=============
-            case SC_TERMINATED:
-                /* [C] View Results
-                 * [D] Finish Op.
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'C':
-                            // View the results of the operation
-                            page = 0;
-                            setScreen(SC_VIEW_RESULTS);
-                            break;
-
-                        case 'D':
-                            // Prompt the user to save
-                            setScreen(SC_SAVE);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-
-                }
-                break;
-
-            //===========================================
-            case SC_VIEW_RESULTS:
-                /* <[*] BCK[0] [#]>
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case '*':
-                            // Go to the previous page
-                            if (page > 0) {
-                                page--;
-                                refreshScreen();
-                            }
-                            break;
-
-                        case '0':
-                            // Return to the previous screen
-                            if (getStatus() == ST_READY) {
-                                page = 0;
-                                setScreen(SC_LOGS_VIEW);
-                            } else {
-                                setScreen(SC_TERMINATED);
-                            }
-                            break;
-
-                        case '#':
-                            // Go to the next page
-                            if (page < (CURRENT_OPERATION.totalNumberOfPoles + 1)) {
-                                page++;
-                                refreshScreen();
-                            }
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-
-                break;
-
-            //===========================================
-            case SC_SAVE:
-                /* [B] Save
-                 * [C] Don't Save
-                 * [D] Back
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'B':
-                            // Go to save selection screen
-                            page = 0;
-                            setScreen(SC_SELECT_SAVE_SLOT);
-                            break;
-
-                        case 'C':
-                            // Return to main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        case 'D':
-                            // Go back to termination screen
-                            setScreen(SC_TERMINATED);
-                            break;
-                            
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-                break;
-
-            //===========================================
-            case SC_SELECT_SAVE_SLOT:
-                /* [A] Slot #<1, 4, 7, 10, 13, 16>
-                 * [B] Slot #<2, 5, 8, 11, 14>
-                 * [C] Slot #<3, 6, 9, 12, 15>
-                 * <[*] BCK[0] [#]>
-                */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case '*':
-                            // Go to the previous page
-                            if (page > 0) {
-                                page--;
-                                refreshScreen();
-                            }
-                            break;
-
-                        case '0':
-                            // Return to the save screen
-                            setScreen(SC_SAVE);
-                            break;
-
-                        case '#':
-                            // Go to the next page
-                            if (page < ((MAX_LOGS - 1) / 3)) {
-                                page++;
-                                refreshScreen();
-                            }
-                            break;
-
-                        case 'A':
-                            // Save into the first row slot
-                            if (getLogSlot(page * 3) == SLOT_USED) {
-                                // If the slot is used, prompt user for verification to overwrite
-                                setScreen(SC_OVERWRITE_LOG_VERIFICATION_1);
-                            } else {
-                                lcd_home();
-                                printf("K: %X", getLogSlot(page * 3));
-                                // Try to save the operation into the logs and throw an error if failed
-                                if (storeOperationIntoLogs(CURRENT_OPERATION, page * 3) == UNSUCCESSFUL) {
-                                    setStatus(ST_ERROR);
-                                    setScreen(SC_SAVE_OPERATION_ERROR);
-                                } else {
-                                    CURRENT_OPERATION.saveSlot = (page * 3) + 1;
-                                    setScreen(SC_SAVE_COMPLETED);
-                                }
-                            }
-                            break;
-
-                        case 'B':
-                            // Save into the second row slot
-                            if (getLogSlot((page * 3) + 1) == SLOT_USED) {
-                                // If the slot is used, prompt user for verification to overwrite
-                                setScreen(SC_OVERWRITE_LOG_VERIFICATION_2);
-                            } else {
-                                // Try to save the operation into the logs and throw an error if failed
-                                if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 1) == UNSUCCESSFUL) {
-                                    setStatus(ST_ERROR);
-                                    setScreen(SC_SAVE_OPERATION_ERROR);
-                                } else {
-                                    CURRENT_OPERATION.saveSlot = (page * 3) + 2;
-                                    setScreen(SC_SAVE_COMPLETED);
-                                }
-                            }
-                            break;
-
-                        case 'C':
-                            // Save into the third row slot
-                            if (getLogSlot((page * 3) + 2) == SLOT_USED) {
-                                // If the slot is used, prompt user for verification to overwrite
-                                setScreen(SC_OVERWRITE_LOG_VERIFICATION_3);
-                            } else {
-                                // Try to save the operation into the logs and throw an error if failed
-                                if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 2) == UNSUCCESSFUL) {
-                                    setStatus(ST_ERROR);
-                                    setScreen(SC_SAVE_OPERATION_ERROR);
-                                } else {
-                                    CURRENT_OPERATION.saveSlot = (page * 3) + 3;
-                                    setScreen(SC_SAVE_COMPLETED);
-                                }
-                            }
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    key_was_pressed = false;
-                }
-               
-                break;
-
-            //===========================================
-            case SC_OVERWRITE_LOG_VERIFICATION_1:
-                /* [C] No
-                 * [D] Yes
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'C':
-                            // Return to save slot selection screen
-                            setScreen(SC_SELECT_SAVE_SLOT);
-                            break;
-
-                        case 'D':
-                            // Try to save the operation into the logs and throw an error if failed
-                            if (storeOperationIntoLogs(CURRENT_OPERATION, page * 3) == UNSUCCESSFUL) {
-                                setStatus(ST_ERROR);
-                                setScreen(SC_SAVE_OPERATION_ERROR);
-                            } else {
-                                CURRENT_OPERATION.saveSlot = (page * 3) + 1;
-                                setScreen(SC_SAVE_COMPLETED);
-                            }
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                }
-                break;
-
-            //===========================================
-            case SC_OVERWRITE_LOG_VERIFICATION_2:
-                /* [C] No
-                 * [D] Yes
-                 */
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'C':
-                            // Return to save slot selection screen
-                            setScreen(SC_SELECT_SAVE_SLOT);
-                            break;
-
-                        case 'D':
-                            // Try to save the operation into the logs and throw an error if failed
-                            if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 1) == UNSUCCESSFUL) {
-                                setStatus(ST_ERROR);
-                                setScreen(SC_SAVE_OPERATION_ERROR);
-                            } else {
-                                CURRENT_OPERATION.saveSlot = (page * 3) + 2;
-                                setScreen(SC_SAVE_COMPLETED);
-                            }
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                }
-                break;
-
-            //===========================================
-            case SC_OVERWRITE_LOG_VERIFICATION_3:
-                /* [C] No
-                 * [D] Yes
-                 */
-                
-                switch (key) {
-                        case 'C':
-                            // Return to save slot selection screen
-                            setScreen(SC_SELECT_SAVE_SLOT);
-                            break;
-
-                        case 'D':
-                            // Try to save the operation into the logs and throw an error if failed
-                            if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 2) == UNSUCCESSFUL) {
-                                setStatus(ST_ERROR);
-                                setScreen(SC_SAVE_OPERATION_ERROR);
-                            } else {
-                                CURRENT_OPERATION.saveSlot = (page * 3) + 3;
-                                setScreen(SC_SAVE_COMPLETED);
-                            }
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                break;
-
-            //===========================================
-            case SC_SAVE_COMPLETED:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                } 
-                break;
-            
-            //============= STATUS: ERROR ===============
-            case SC_LOG_VIEW_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                }
-                break;
-
-            //===========================================
-            case SC_INVALID_STATE_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                } 
-                break;
+            // The operating screen ends the operation, every other screen shows that the actuators are latched off
+            if (getScreen() == SC_OPERATING) {
+                event.type = EV_ESTOP;
+                event.data = 0;
+                dispatchEvent(&event);
+            } else {
+                setStatus(ST_ERROR);
+                setScreen(SC_EMERGENCY_STOP_ERROR);
+            }
+            continue;
+        }
 
-            //===========================================
-            case SC_INVALID_SCREEN_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                } 
-                break;
+        // Idle the CPU until the next interrupt while there is nothing to do. An event posted just
+        // before idling is picked up after the next Timer2 tick, at most 1 ms later
+        if (Event_Get(&event) == UNSUCCESSFUL) {
+            Power_Idle();
+            continue;
+        }
+        PROBE_EVENT(&event);
 
-            //===========================================
-            case SC_SAVE_OPERATION_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the operation complete screen
-                            setStatus(ST_COMPLETED_OP);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                } 
-                break;
+        // A slot is free again, so let the UART interrupt post the message code it held back
+        if (uartReceiveDeferred) {
+            uartReceiveDeferred = false;
+            if (getScreen() == SC_OPERATING) {
+                UART_Listen();
+            }
+        }
 
-            //===========================================
-            case SC_UNHANDLED_ARDUINO_MESSAGE_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                } 
-                break;
-            //===========================================
-            case SC_SEND_ARDUINO_MESSAGE_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                } 
-                break;
-            //===========================================
-            case SC_UART_INIT_ERROR:
-                /* [D] Reinitialize
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-
-                            lcd_set_ddram_addr(LCD_LINE3_ADDR);
-                            printf(" Reinitializing ");
-                            // Reinitialize UART
-                            if (UART_Init(9600) == SUCCESSFUL) {
-                                setStatus(ST_STANDBY);
-                            } else {
-                                // Wait some time before able to reinitialize
-                                __delay_ms(100);
-                                refreshScreen();
-                            }
-
-                            break;
-
-                        default:
-                            break;
-                    }
- 
-                    key_was_pressed = false;
-                } 
-                break;
-            //===========================================
-            case SC_UART_READ_TIMEOUT_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }   
- 
-                    key_was_pressed = false;
-                } 
-                break;
+        // Finished I2C transfers run their own callbacks
+        if (event.type == EV_I2C_DONE) {
+            I2C_Complete();
+            continue;
+        }
 
-            //===========================================
-            case SC_SENSOR_TIMEOUT_ERROR:
-                /* [D] OK
-                 */
-
-                if (key_was_pressed) {
-                    switch (key) {
-                        case 'D':
-                            // Return to the main menu
-                            setStatus(ST_READY);
-                            break;
-
-                        default:
-                            break;
-                    }   
- 
-                    key_was_pressed = false;
-                } 
-                break;
+        // Drop a stuck I2C transfer so it cannot hold the bus
+        if (event.type == EV_TICK) {
+            I2C_Service();
+        }
 
-            //===========================================
-            default:
-                break;
+        // Keep the cached time in step with the RTC
+        if (event.type == EV_RTC_SECOND) {
+            RTC_Update();
         }
 
-        // 1ms delay for every iteration
-        __delay_ms(1);
-        tick++;
+        // Let the current screen handle the event
+        dispatchEvent(&event);
 
-        if (getScreen() == SC_OPERATING) {
-            durationTick++;
-            if (durationTick == 1000) {
-                durationTick = 0;
-                durationSeconds++;
-            }
-        }
-        
-        if (tick == 1000) {
-            // This occurs every second
-            tick = 0;
+        // Leave the screen once it has been left idle for its timeout
+        if (SoftTimer_Expired(&screenTimer)) {
+            SoftTimer_Stop(&screenTimer);
+            setStatus(screens[getScreen()].timeoutStatus);
         }
     }
 }
@@ -1557,11 +457,18 @@ void initialize(void) {
     // Set all A/D ports to digital (pg. 222)
     ADCON1 = 0b00001111;
     
+    // Use interrupt priorities: RB0 (emergency stop) is always high priority, the rest are set low
+    IPEN = 1;
+
     // Enable RB1 (keypad data available) interrupt
+    INT1IP = 0;
     INT1E= 1;
     
     // Enable RB0 (emergency stop) interrupt
     INT0E = 1;
+
+    // The UART receive interrupt is enabled only while operating
+    RCIP = 0;
     
     // Initialize LCD
     initLCD();
@@ -1569,8 +476,15 @@ void initialize(void) {
    // Initialize I2C Master with 100 kHz clock
     I2C_Master_Init(100000);
 
-    // Enable interrupts
-    ei();
+    // Start the millisecond timebase
+    Timer_Init();
+
+    // Start the timing probes' cycle counter (PROBES_ENABLED builds only)
+    PROBE_INIT();
+
+    // Enable high and low priority interrupts
+    GIEH = 1;
+    GIEL = 1;
     
     // Initialize UART
     if (UART_Init(9600) == UNSUCCESSFUL) {
@@ -1581,6 +495,9 @@ void initialize(void) {
     // Write time ( DO NOT UNCOMMENT )
 //    rtcSetTime(valueToWriteToRTC);
 
+    // Start the RTC square wave and cache the time
+    RTC_Init();
+
     // Initialize Status
     setStatus(ST_STANDBY);
     
@@ -1591,130 +508,161 @@ Status getStatus(void) {
 }
 
 void setStatus(Status newStatus) {
-    // Sets the new status and performs an initial function
+    // Sets the new status and performs its initial function from the status table
+
+    // Statuses without an initial function are invalid, throw an error
+    if (newStatus >= ST_COUNT || statusEntries[newStatus] == NULL) {
+        CURRENT_STATUS = ST_ERROR;
+        CURRENT_SCREEN = SC_INVALID_SCREEN_ERROR;
+        // Display invalid state error
+        displayPage("     ERROR      ",
+                    " Invalid state  ",
+                    "                ",
+                    "[D] OK          ");
+        return;
+    }
 
-    // Create temporary variables for UART communication
-    unsigned char temporaryResult;
-    unsigned char temporaryByte;
-        
     // Update the status
     CURRENT_STATUS = newStatus;
 
-    switch (newStatus) {
-        case ST_STANDBY:
-        // Places the robot into standby mode (where time displays)
-            setScreen(SC_STANDBY);
-            break;
-            
-        case ST_READY:
-        // Status to navigate robot menus
-            setScreen(SC_MENU);
-            emergency_stop_pressed = false;
-            break;
+    statusEntries[newStatus]();
+}
 
-        case ST_ERROR:
-        // Status when an error occurs (prevents screen from automatically returning over time)
-            // do nothing
-            break;
+// Places the robot into standby mode (where time displays)
+void enterStandby(void) {
+    setScreen(SC_STANDBY);
+}
 
-        case ST_OPERATE_START:
-        // Status used to begin an operation
-            CURRENT_OPERATION = EmptyOperation;
-
-            // Initialize operation stats
-            unsigned char condensedTime[5];
-            condensedReadTime(condensedTime);
-            for (char i = 0; i < 5; i++) {
-                CURRENT_OPERATION.startTime[i] = condensedTime[i];
-            }
+// Status to navigate robot menus
+void enterReady(void) {
+    setScreen(SC_MENU);
+    emergency_stop_pressed = false;
+    releaseActuators();
 
-            // Restart the duration timer
-            durationTick = 0;
-            durationSeconds = 0;
-            
-            // Tell the Arduino to start
-            temporaryResult = UART_Write(MSG_P2A_START);
+    // An emergency stop skips retracting the pusher, so bring it home now that it can move again
+    returnStepperHome();
+}
 
-            // Throw an error if there was an error with UART communication
-            if (temporaryResult == UART_WRITE_TIMEOUT) {
-                CURRENT_STATUS = ST_ERROR;
-                setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
-                
-                lcd_set_ddram_addr(LCD_LINE3_ADDR);
-                printf("     START      ");
-            }
+// Status when an error occurs (prevents screen from automatically returning over time)
+void enterError(void) {
+    // Nothing to do, the caller sets the error screen
+}
 
-            // temporaryResult = UART_Write(CURRENT_OPERATION.tiresRemaining);
-            
-            // // Throw an error if there was an error with UART communication
-            // if (temporaryResult == UART_WRITE_TIMEOUT) {
-            //     CURRENT_STATUS = ST_ERROR;
-            //     setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
-                
-            //     lcd_set_ddram_addr(LCD_LINE3_ADDR);
-            //     printf("   TIRES_LOAD  ");
-            // }
+// Status used to begin an operation
+void enterOperateStart(void) {
+    // Create temporary variables for UART communication
+    unsigned char temporaryResult;
 
-            setScreen(SC_OPERATING);
+    CURRENT_OPERATION = EmptyOperation;
 
-            break;
+    // Initialize operation stats
+    unsigned char condensedTime[5];
+    RTC_GetCondensedTime(condensedTime);
+    for (char i = 0; i < 5; i++) {
+        CURRENT_OPERATION.startTime[i] = condensedTime[i];
+    }
 
-        case ST_OPERATE_DRIVING:
-        // Status used while the robot is driving/scanning for poles
-            // refresh operation screen
-            setScreen(SC_OPERATING);
-            break;
+    // Restart the duration timer
+    operationStartTime = Timer_Millis();
+    deployMisalignment = 0;
+    
+    // The magazine model is the source of truth for the tires remaining
+    CURRENT_OPERATION.tiresRemaining = getTiresRemaining();
 
-        case ST_OPERATE_POLE_DETECTED:
-        // Status used when a pole is detected
-            // refresh operation screen
-            setScreen(SC_OPERATING);
-            break;
+    // Tell the Arduino to start
+    temporaryResult = UART_Write(MSG_P2A_START);
 
-        case ST_OPERATE_DEPLOYING_TIRE:
-        // Robot is deploying a tire using the stepper motor
+    // Throw an error if there was an error with UART communication
+    if (temporaryResult == UART_WRITE_TIMEOUT) {
+        CURRENT_STATUS = ST_ERROR;
+        setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
+        
+        lcd_set_ddram_addr(LCD_LINE3_ADDR);
+        printf("     START      ");
+        return;
+    }
 
-            // drive the stepper motor forward
-            driveStepper(REVOLUTIONS_TO_DROP_ONE_TIRE, FORWARD);
-            durationSeconds += DEPLOYMENT_DURATION;
+    // Tell the Arduino how many tires are loaded
+    temporaryResult = UART_Write(CURRENT_OPERATION.tiresRemaining);
+    
+    // Throw an error if there was an error with UART communication
+    if (temporaryResult == UART_WRITE_TIMEOUT) {
+        CURRENT_STATUS = ST_ERROR;
+        setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
+        
+        lcd_set_ddram_addr(LCD_LINE3_ADDR);
+        printf("   TIRES_LOAD   ");
+        return;
+    }
 
-            // tell arduino that deployment was completed and handle errors
-            if (UART_Write(MSG_P2A_DEPLOYMENT_COMPLETE) == UART_WRITE_TIMEOUT) {
-                CURRENT_STATUS = ST_ERROR;
-                setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
-                
-                lcd_set_ddram_addr(LCD_LINE3_ADDR);
-                printf("DEPLYMNT_COMPLTE");
-            }
+    // Tell the Arduino whether to map the poles before deploying
+    temporaryResult = UART_Write(twoPassOperation ? OP_MODE_TWO_PASS : OP_MODE_SINGLE_PASS);
+    
+    // Throw an error if there was an error with UART communication
+    if (temporaryResult == UART_WRITE_TIMEOUT) {
+        CURRENT_STATUS = ST_ERROR;
+        setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
+        
+        lcd_set_ddram_addr(LCD_LINE3_ADDR);
+        printf("    OP_MODE     ");
+        return;
+    }
 
-            // refresh operation screen
-            setScreen(SC_OPERATING);
+    setScreen(SC_OPERATING);
 
-            break;
+    // Listen for messages from the Arduino
+    UART_Listen();
 
-        case ST_OPERATE_RETURN:
-        // Status used when the robot is returning to the start
-            setScreen(SC_OPERATING);
-            break;
+    // Pre-roll the first tire while the robot drives to the first pole
+    if (CURRENT_OPERATION.tiresRemaining > 0) {
+        prepareDeployment();
+    }
+}
 
-        case ST_COMPLETED_OP:
-        // Status used when the operation is completed
-            CURRENT_OPERATION.duration = durationSeconds;
-            setScreen(SC_TERMINATED);
-            break;
+// Statuses used while the robot drives, maps the poles, stops at a pole or returns to the start
+void enterOperating(void) {
+    // refresh operation screen
+    setScreen(SC_OPERATING);
+}
 
-        default:
-        // For an invalid state, throw an error
-            CURRENT_STATUS = ST_ERROR;
-            CURRENT_SCREEN = SC_INVALID_SCREEN_ERROR;
-            // Display invalid state error
-            displayPage("     ERROR      ",
-                        " Invalid state  ",
-                        "                ",
-                        "[D] OK          ");
-            
-            break;
+// Robot is deploying a tire using the stepper motor
+void enterDeployingTire(void) {
+    // drive the stepper motor forward until the tire drops
+    deployTire();
+    CURRENT_OPERATION.tiresRemaining = getTiresRemaining();
+
+    // tell arduino that deployment was completed along with the tires remaining, and handle errors
+    if (UART_Write(MSG_P2A_DEPLOYMENT_COMPLETE) == UART_WRITE_TIMEOUT ||
+        UART_Write(CURRENT_OPERATION.tiresRemaining) == UART_WRITE_TIMEOUT) {
+        CURRENT_STATUS = ST_ERROR;
+        setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
+        
+        lcd_set_ddram_addr(LCD_LINE3_ADDR);
+        printf("DEPLYMNT_COMPLTE");
+        return;
+    }
+
+    // refresh operation screen
+    setScreen(SC_OPERATING);
+}
+
+// Ends the operation in progress, recording its duration once. ST_COMPLETED_OP is entered again to
+// retry a failed save, so the duration is not recorded there
+void finishOperation(void) {
+    CURRENT_OPERATION.duration = (Timer_Millis() - operationStartTime) / 1000;
+    setStatus(ST_COMPLETED_OP);
+}
+
+// Status used when the operation is completed
+void enterCompletedOp(void) {
+    // Stop listening for messages from the Arduino
+    RCIE = 0;
+
+    // Retract the magazine pusher so the robot is ready to be reloaded
+    if (!emergency_stop_pressed) {
+        returnStepperHome();
     }
+    setScreen(SC_TERMINATED);
 }
 
 // Screen functions
@@ -1723,668 +671,1958 @@ Screen getScreen(void) {
 }
 
 void setScreen(Screen newScreen) {
-    // Sets the new screen and performs an initial function
+    // Sets the new screen and draws it
 
-    // Create temporary variables for UART result control
-    unsigned char temporaryResult;
-    unsigned short temporaryShort;
-    unsigned char temporaryByte;
-
-    unsigned char i; // iterative variable
+    // Screens without a renderer are invalid, throw an error
+    if (newScreen >= SC_COUNT || screens[newScreen].render == NULL) {
+        // Set status to ST_ERROR
+        CURRENT_STATUS = ST_ERROR;
+        
+        // Display the invalid screen error instead
+        newScreen = SC_INVALID_SCREEN_ERROR;
+    }
 
     // Update the current screen
     CURRENT_SCREEN = newScreen;
 
-    switch (newScreen) {
-        case SC_STANDBY:
-        // Standby screen. Time / date displays here
-            displayPage("   Skybot Inc   ",
-                        "                ",
-                        "                ",
-                        "                ");
-            break;
-            
-        case SC_MENU:
-        // Main navigation menu
-            displayPage("[A] Start Op.   ",
-                        "[B] Logs        ",
-                        "[C] About       ",
-                        "[D] Debug       ");
-
-            // Reset returnToStandby timers
-            returnToStandbyTick = 0;
-            returnToStandbyCounter = 0;
-            break;
-
-        case SC_ABOUT:
-        // Displays some information about the project
-            displayPage("Autonomous tire ",
-                        "stacking robot  ",
-                        "by Skybot Inc.  ",
-                        "[D] Back        ");
-            break;
-            
-        case SC_LOGS_MENU:
-        // Navigation menu for logs
-            displayPage("[A] View Logs   ",
-                        "[B] UNAVAILABLE ",
-                        "                ",
-                        "[D] Back        ");
-            break;
+    // Restart the timeout of screens that leave on their own
+    if (screens[newScreen].timeoutSeconds > 0) {
+        SoftTimer_Start(&screenTimer, screens[newScreen].timeoutSeconds * 1000UL);
+    } else {
+        SoftTimer_Stop(&screenTimer);
+    }
 
-        case SC_LOGS_VIEW:
-            // Menu to view all the logs
-            displayMenuPage("                ",
-                            "                ",
-                            "                ",
-                            page > 0, page < (MAX_LOGS - 1) / 3);
+    screens[newScreen].render();
+}
 
-            // First row of slots
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
+void dispatchEvent(Event *event) {
+    // Hands an event to the current screen: key presses to its key handler, everything else to its event handler
+    const ScreenDescriptor *screen = &screens[getScreen()];
 
-            // Display whether the slot is taken or not
-            if (getLogSlot(page * 3) == SLOT_USED) {
-                printf("[A] Slot %02d     ", (page * 3) + 1);
-            } else {
-                printf("Slot %02d is empty", (page * 3) + 1);
-            }
+    if (event->type == EV_KEY) {
+        if (screen->onKey != NULL) {
+            screen->onKey(event->data);
+        }
+    } else if (screen->onEvent != NULL) {
+        PROBE_BEGIN(PROBE_SCREEN_EVENT);
+        screen->onEvent(event);
+        PROBE_END(PROBE_SCREEN_EVENT);
+    }
+}
 
-            // Second row of slots
-            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+void refreshScreen(void) {
+    setScreen(getScreen());
+}
 
-            // Display whether the slot is taken or not
-            if (getLogSlot((page * 3) + 1) == SLOT_USED) {
-                printf("[B] Slot %02d     ", (page * 3) + 2);
-            } else {
-                printf("Slot %02d is empty", (page * 3) + 2);
-            }
+void cyclePState(unsigned char pNum) {
+    switch (pstates[pNum]) {
+        case PS_None:
+            pstates[pNum] = PS_0T;
+            break;
 
-            // Third row of slots
-            lcd_set_ddram_addr(LCD_LINE3_ADDR);
+        case PS_0T:
+            pstates[pNum] = PS_1T;
+            break;
 
-            // Display whether the slot is taken or not
-            if (getLogSlot((page * 3) + 2) == SLOT_USED) {
-                printf("[C] Slot %02d     ", (page * 3) + 3);
-            } else {
-                printf("Slot %02d is empty", (page * 3) + 3);
-            }
+        case PS_1T:
+            pstates[pNum] = PS_2T;
+            break;
 
-        break;
-            
-        case SC_DEBUG:
-        // Debug menu
-            displayPage("[A] Motor Debug ",
-                        "[B] Log Debug   ",
-                        "[C] Sensor Debug",
-                        "[D] Back        ");
+        case PS_2T:
+            pstates[pNum] = PS_None;
             break;
+    }
+}
 
-        case SC_DEBUG_LOG:
-        // Log debug menu
-            displayPage("                ",
-                        "                ",
-                        "[C] UNAVAILABLE ",
-                        "[D] Back        ");
+// Screen functions
+// Standby screen. Time / date displays here
+void renderStandby(void) {
+    unsigned char time[7];
 
-            // Display the number of log slots available
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
-            printf("Slots Open:    %01d", getSlotsAvailable());
+    displayPage("   Skybot Inc   ",
+                "                ",
+                "                ",
+                "                ");
 
-            // Display the slots taken
-            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+    RTC_GetTime(time);
+    displayTime(time);
+}
 
-            // Print left side spaces
-            for (i = 0; i < ((16 - MAX_LOGS) / 2); i++) {
-                printf(" ");
-            }
+/* [Any Key] - Go into the main menu
+ */
+void keyStandby(unsigned char key) {
+    setStatus(ST_READY);
+}
 
-            // Print the slots
-            for (i = 0; i < MAX_LOGS; i++) {
-                printf("%c", getLogSlot(i) == SLOT_USED ? '1' : '0');
-            }
+// Redraw the time on standby screen each time the second changes
+void eventStandby(Event *event) {
+    unsigned char time[7];
 
-            // Print right side spaces
-            for (i = 0; i < ((16 - MAX_LOGS) / 2); i++) {
-                printf(" ");
-            }
+    if (event->type == EV_RTC_SECOND) {
+        RTC_GetTime(time);
+        displayTime(time);
+    }
+}
 
+// Main navigation menu
+void renderMenu(void) {
+    displayPage("[A] Start Op.   ",
+                "[B] Logs        ",
+                "[C] About       ",
+                "[D] Debug       ");
+}
+
+/* [A] Load Tires
+ * [B] Logs
+ * [C] About
+ * [D] Debug
+ */
+void keyMenu(unsigned char key) {
+    switch (key) {
+        case 'A':
+            // Do not start with the actuators latched off by an emergency stop
+            if (actuatorsHalted) {
+                setStatus(ST_ERROR);
+                setScreen(SC_EMERGENCY_STOP_ERROR);
+                break;
+            }
+            setScreen(SC_OPERATION_INIT);
             break;
-            
-        case SC_DEBUG_MOTOR:
-        // Motor debug menu
-            displayPage("[A] Forward     ",
-                        "[B] Backward    ",
-                        "[C] Off         ",
-                        "[D] Return      ");
-            break;
-            
-        case SC_DEBUG_STEPPER:
-        // Stepper debug menu
-            displayPage("[1] 1 Forward   ",
-                        "[3] 1 Back      ",
-                        "[4] Tire Forward",
-                        "[6] Tire Back   ");
+
+        case 'B':
+            setScreen(SC_LOGS_MENU);
             break;
 
-        case SC_DEBUG_SENSOR:
-        // Sensor debug menu
-            displayPage("                ",
-                        "                ",
-                        "[C] Read Sensor ",
-                        "[D] Back        ");
+        case 'C':
+            setScreen(SC_ABOUT);
             break;
 
-        case SC_DEBUG_CLOCK:
-        // Clock debug menu
-            displayPage("                ",
-                        "                ",
-                        "[C] Reset Time  ",
-                        "[D] Back        ");
+        case 'D':
+            setScreen(SC_DEBUG);
             break;
 
-        case SC_OPERATION_DBG:
-            
-            displayPage("                ",
-                        "                ",
-                        "                ",
-                        "[D] Continue    ");
+        case '7':
+        for (unsigned char i = 0; i < 10; i++) {
+            if (i < 4) {
+                pstates[i] = PS_0T;
+            } else {
+                pstates[i] = PS_None;
+            }
+        }
+            setScreen(SC_OPERATION_DBG);
 
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
-            printf("   ");
-            for (unsigned char i = 0; i < 10; i++) {
-                if (pstates[i] == PS_0T || pstates[i] == PS_1T || pstates[i] == PS_2T) {
-                    printf("%X", pstates[i]);
-                } else if (pstates[i] == PS_None) {
-                    printf("-");
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Displays some information about the project
+void renderAbout(void) {
+    displayPage("Autonomous tire ",
+                "stacking robot  ",
+                "by Skybot Inc.  ",
+                "[D] Back        ");
+}
+
+/* [D] Back
+ */
+void keyAbout(unsigned char key) {
+   switch (key) {
+        case 'D':
+            setScreen(SC_MENU);
+            break;
+
+        default:
+            break;
+   }
+}
+
+// Debug menu
+void renderDebug(void) {
+    displayPage("[A] Motor Debug ",
+                "[B] Log Debug   ",
+                "[C] Sensor Debug",
+                "[D] Back        ");
+}
+
+/* [A] Motor Debug
+ * [B] Log Debug
+ * [C] Sensor Debug
+ * [D] Back
+ * [*] Dump timing probes over UART, [#] Reset them (PROBES_ENABLED builds only)
+ */
+void keyDebug(unsigned char key) {
+   switch (key) {
+#ifdef PROBES_ENABLED
+        case '*':
+            if (Probe_Dump(MSG_P2A_PROBE_DUMP) == UART_WRITE_TIMEOUT) {
+                setStatus(ST_ERROR);
+                setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
+
+                lcd_set_ddram_addr(LCD_LINE3_ADDR);
+                printf("   PROBE_DUMP   ");
+            }
+            break;
+
+        case '#':
+            Probe_Reset();
+            break;
+#endif
+
+        case 'A':
+            setScreen(SC_DEBUG_MOTOR);
+            break;
+
+        case 'B':
+            setScreen(SC_DEBUG_LOG);
+            break;
+
+        case 'C':
+            setScreen(SC_DEBUG_SENSOR);
+            break;
+
+        case 'D':
+            setScreen(SC_MENU);
+            break;
+
+        case '1':
+            setScreen(SC_DEBUG_CLOCK);
+            break;
+
+        default:
+            break;
+   }
+}
+
+// Log debug menu
+void renderDebugLog(void) {
+    unsigned char i; // iterative variable
+
+    displayPage("                ",
+                "                ",
+                "[C] UNAVAILABLE ",
+                "[D] Back        ");
+
+    // Display the number of log slots available
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+    printf("Slots Open:    %01d", getSlotsAvailable());
+
+    // Display the slots taken
+    lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+    // Print left side spaces
+    for (i = 0; i < ((16 - MAX_LOGS) / 2); i++) {
+        printf(" ");
+    }
+
+    // Print the slots
+    for (i = 0; i < MAX_LOGS; i++) {
+        printf("%c", getLogSlot(i) == SLOT_USED ? '1' : '0');
+    }
+
+    // Print right side spaces
+    for (i = 0; i < ((16 - MAX_LOGS) / 2); i++) {
+        printf(" ");
+    }
+}
+
+/* [C] Reset Slots
+ * [D] Back
+ */
+void keyDebugLog(unsigned char key) {
+   switch (key) {
+        case 'C':
+//                            writeAllLogSlots(0x0000);
+            refreshScreen();
+            break;
+
+        case 'D':
+            setScreen(SC_DEBUG);
+            break;
+
+        default:
+            break;
+   }
+}
+
+// Motor debug menu
+void renderDebugMotor(void) {
+    displayPage("[A] Forward     ",
+                "[B] Backward    ",
+                "[C] Off         ",
+                "[D] Return      ");
+}
+
+/* [A] Forward
+ * [B] Backward
+ * [C] Off
+ * [D] Back
+ * [2] Calibrate Trim
+ */
+void keyDebugMotor(unsigned char key) {
+    switch (key) {
+        case 'A':
+            // Tell Arduino to drive motors forward
+            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_DRIVE_FORWARD, "DBG_DRIVE_FRWARD");
+            break;
+
+        case 'B':
+            // Tell Arduino to drive motors backward
+            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_DRIVE_BACKWARD, "DEBUG_DRIVE_BACK");
+            break;
+
+        case 'C':
+            // Tell Arduino to stop driving motors
+            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_STOP, "   DEBUG_STOP   ");
+            break;
+
+        case 'D':
+            // Return and tell Arduino to stop driving
+            UART_Write_With_Error_Handle(MSG_P2A_DEBUG_STOP, "   DEBUG_STOP   ");
+            setScreen(SC_DEBUG);
+            break;
+
+        case '1':
+            setScreen(SC_DEBUG_STEPPER);
+            break;
+
+        case '2':
+            // Tell Arduino to drive a reference run and calibrate the motor trim
+            UART_Write_With_Error_Handle(MSG_P2A_CALIBRATE_TRIM, " CALIBRATE_TRIM ");
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Stepper debug menu
+void renderDebugStepper(void) {
+    displayPage("[1] 1 Forward   ",
+                "[3] 1 Back      ",
+                "[4] Tire Forward",
+                "[6] Tire Back   ");
+}
+
+/* [1] 1 Forward
+ * [3] 1 Back
+ * [4] Tire Forward
+ * [6] Tire Back
+ * [0] Stop
+ * [D] Return
+ */
+void keyDebugStepper(unsigned char key) {
+    switch (key) {                        
+        case 'D':
+            setScreen(SC_DEBUG);
+            break;
+
+        case '1':
+            // Drive stepper 1 revolution forward
+            driveStepper(1, FORWARD);
+            break;
+
+        case '3':
+            // Drive stepper 1 revolution backward
+            driveStepper(1, BACKWARD);
+            break;
+
+        case '0':
+            STEPPER_EN = 0;
+            STEPPER_DIR = 0;
+            STEPPER_PULSE = 0;
+            break;
+
+        case '4':
+            // Make enough revolutions to deploy a tire (forward)
+            driveStepper(REVOLUTIONS_TO_DROP_ONE_TIRE, FORWARD);
+            break;
+
+        case '6':
+            // Make enough revolutions for one tire (backward)
+            driveStepper(REVOLUTIONS_TO_DROP_ONE_TIRE, BACKWARD);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Sensor debug menu
+void renderDebugSensor(void) {
+    displayPage("                ",
+                "                ",
+                "[C] Read Sensor ",
+                "[D] Back        ");
+}
+
+/* [1] Initialize
+ * [C] Read Sensor
+ */
+void keyDebugSensor(unsigned char key) {
+    unsigned char temporaryResult;
+    unsigned char temporaryByte;
+    unsigned short sensorReading;
+
+    switch (key) {
+
+        case '1':
+            // Print the first two lines of the screen
+            lcd_home();
+            printf("Starting sensor ");
+
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+            printf("                ");
+
+            // Request sensor initialization from the Arduino
+            temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_INITIALIZE_SENSOR, &temporaryByte);
+
+            // Throw an error if UART communication failed
+            if (temporaryResult == UART_READ_TIMEOUT) {
+                setStatus(ST_ERROR);
+                setScreen(SC_UART_READ_TIMEOUT_ERROR);
+                break;
+
+            } else if (temporaryResult == UART_WRITE_TIMEOUT) {
+                setStatus(ST_ERROR);
+                setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);
+
+                lcd_set_ddram_addr(LCD_LINE3_ADDR);
+                printf("RQST_INIT_SENSOR");
+                break;
+            } 
+
+            // Display whether the initialization was a success or not
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+            if (temporaryByte == MSG_A2P_SUCCESS) {
+                printf("Successful start");
+
+            } else if (temporaryByte == MSG_A2P_FAILED) {
+                printf("Failed to start ");
+            }
+
+            break;
+
+
+        case 'C':
+            // Print first two lines of screen
+            lcd_home();
+            printf("Reading distance");
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+            printf("                ");
+
+            // Retrieve sensor data from Arduino
+            temporaryResult = UART_Request_Short(MSG_P2A_DEBUG_SENSOR_BASE, &sensorReading);
+
+            // Throw an error if the UART communication failed
+            UART_Request_Error_Handling(temporaryResult, "DEBUG_SNSR_BASE ");
+
+            // Write sensor data to LCD
+            lcd_home();
+            if (sensorReading) {
+                printf("SNS_BASE:    %03d", sensorReading);
+            } else {
+                printf("SNS_BASE:   None");
+            }
+
+            // Display next sensor results on the second line
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+            // Retrieve sensor data from Arduino
+            temporaryResult = UART_Request_Short(MSG_P2A_DEBUG_SENSOR_TIRE1, &sensorReading);
+
+            // Throw an error if the UART communication failed
+            UART_Request_Error_Handling(temporaryResult, "DEBUG_SNSR_TIRE1");
+
+            // Write sensor data to LCD
+            if (sensorReading) {
+                printf("SNS_TIR1:    %03d", sensorReading);
+            } else {
+                printf("SNS_TIR1:   None");
+            }
+
+            lcd_set_ddram_addr(LCD_LINE3_ADDR);
+
+            // Retrieve sensor data from Arduino
+            temporaryResult = UART_Request_Short(MSG_P2A_DEBUG_SENSOR_TIRE2, &sensorReading);
+
+            // Throw an error if the UART communication failed
+            UART_Request_Error_Handling(temporaryResult, "DEBUG_SNSR_TIRE2");
+
+            // Write sensor data to LCD
+            if (sensorReading) {
+                printf("SNS_TIR2:    %03d", sensorReading);
+            } else {
+                printf("SNS_TIR2:   None");
+            }
+            break;
+
+        case 'D':
+            setScreen(SC_DEBUG);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Clock debug menu
+void renderDebugClock(void) {
+    displayPage("                ",
+                "                ",
+                "[C] Reset Time  ",
+                "[D] Back        ");
+
+    // Display the share of time the CPU has been awake rather than idle ([A] restarts the count)
+    lcd_set_ddram_addr(LCD_LINE2_ADDR);
+    printf("[A] Awake:  %3d%%", Power_AwakePercent());
+}
+
+/* [A] Reset Awake Time
+ * [C] Reset Time  
+ * [D] Back
+ */
+void keyDebugClock(unsigned char key) {
+   switch (key) {
+        case 'A':
+            Power_ResetStats();
+            refreshScreen();
+            break;
+
+        case 'C':
+            RTC_SetTime(valueToWriteToRTC);
+
+            // Display feedback message
+            lcd_set_ddram_addr(LCD_LINE1_ADDR);
+            printf(" Time Rewritten ");
+            break;
+
+        case 'D':
+            setScreen(SC_DEBUG);
+            break;
+
+        default:
+            break;
+   }
+}
+
+// Navigation menu for logs
+void renderLogsMenu(void) {
+    displayPage("[A] View Logs   ",
+                "[B] UNAVAILABLE ",
+                "                ",
+                "[D] Back        ");
+}
+
+/* [A] View Logs
+ * [B] Download
+ * [D] Back
+ */
+void keyLogsMenu(unsigned char key) {
+    switch (key) {
+        case 'A':
+            page = 0;
+            setScreen(SC_LOGS_VIEW);
+            break;
+
+        case 'B':
+            // to be implemented
+            break;
+
+        case 'D':
+            setScreen(SC_MENU);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Menu to view all the logs
+void renderLogsView(void) {
+    displayMenuPage("                ",
+                    "                ",
+                    "                ",
+                    page > 0, page < (MAX_LOGS - 1) / 3);
+
+    // First row of slots
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+
+    // Display whether the slot is taken or not
+    if (getLogSlot(page * 3) == SLOT_USED) {
+        printf("[A] Slot %02d     ", (page * 3) + 1);
+    } else {
+        printf("Slot %02d is empty", (page * 3) + 1);
+    }
+
+    // Second row of slots
+    lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+    // Display whether the slot is taken or not
+    if (getLogSlot((page * 3) + 1) == SLOT_USED) {
+        printf("[B] Slot %02d     ", (page * 3) + 2);
+    } else {
+        printf("Slot %02d is empty", (page * 3) + 2);
+    }
+
+    // Third row of slots
+    lcd_set_ddram_addr(LCD_LINE3_ADDR);
+
+    // Display whether the slot is taken or not
+    if (getLogSlot((page * 3) + 2) == SLOT_USED) {
+        printf("[C] Slot %02d     ", (page * 3) + 3);
+    } else {
+        printf("Slot %02d is empty", (page * 3) + 3);
+    }
+}
+
+/*
+ * [A] Slot #<1, 4, 7, 10, 13, 16>
+ * [B] Slot #<2, 5, 8, 11, 14>
+ * [C] Slot #<3, 6, 9, 12, 15>
+ * <[*] BCK[0] [#]>
+ */
+void keyLogsView(unsigned char key) {
+    switch (key) {
+        case '*':
+            // Go to the previous page
+            if (page > 0) {
+                page--;
+                refreshScreen();
+            }
+            break;
+
+        case '0':
+            // Return to the logs menu
+            setScreen(SC_LOGS_MENU);
+            break;
+
+        case '#':
+            // Go to the next page
+            if (page < (MAX_LOGS - 1) / 3) {
+                page++;
+                refreshScreen();
+            }
+            break;
+
+        case 'A':
+            // View operation from log slot A
+            if (getLogSlot(page * 3) == SLOT_USED) {
+                if (getOperationFromLogs(&CURRENT_OPERATION, (page * 3)) == SUCCESSFUL) {
+                    page = 0;
+                    setScreen(SC_VIEW_RESULTS);
+                } else {
+                    setStatus(ST_ERROR);
+                    setScreen(SC_LOG_VIEW_ERROR);
+                }
+            }
+            break;
+
+        case 'B':
+            // View operation from log slot B
+            if (getLogSlot((page * 3) + 1) == SLOT_USED) {
+                if (getOperationFromLogs(&CURRENT_OPERATION, ((page * 3) + 1)) == SUCCESSFUL) {
+                    page = 0;
+                    setScreen(SC_VIEW_RESULTS);
                 } else {
-                    printf("?");
+                    setStatus(ST_ERROR);
+                    setScreen(SC_LOG_VIEW_ERROR);
+                }
+            }
+            break;
+
+        case 'C':
+            // View operation from log slot C
+            if (getLogSlot((page * 3) + 2) == SLOT_USED) {
+                if (getOperationFromLogs(&CURRENT_OPERATION, ((page * 3) + 2)) == SUCCESSFUL) {
+                    page = 0;
+                    setScreen(SC_VIEW_RESULTS);
+                } else {
+                    setStatus(ST_ERROR);
+                    setScreen(SC_LOG_VIEW_ERROR);
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void renderOperationDbg(void) {
+    displayPage("                ",
+                "                ",
+                "                ",
+                "[D] Continue    ");
+
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+    printf("   ");
+    for (unsigned char i = 0; i < 10; i++) {
+        if (pstates[i] == PS_0T || pstates[i] == PS_1T || pstates[i] == PS_2T) {
+            printf("%X", pstates[i]);
+        } else if (pstates[i] == PS_None) {
+            printf("-");
+        } else {
+            printf("?");
+        }
+    }
+    printf("   ");
+}
+
+void keyOperationDbg(unsigned char key) {
+    switch (key) {
+        case 'D':
+            setScreen(SC_OPERATION_SENSOR_CHECK);
+            break;
+
+        case '1':
+            cyclePState(0);
+            refreshScreen();
+            break;
+
+        case '2':
+            cyclePState(1);
+            refreshScreen();
+            break;
+
+        case '3':
+            cyclePState(2);
+            refreshScreen();
+            break;
+
+        case '4':
+            cyclePState(3);
+            refreshScreen();
+            break;
+
+        case '5':
+            cyclePState(4);
+            refreshScreen();
+            break;
+
+        case '6':
+            cyclePState(5);
+            refreshScreen();
+            break;
+
+        case '7':
+            cyclePState(6);
+            refreshScreen();
+            break;
+
+        case '8':
+            cyclePState(7);
+            refreshScreen();
+            break;
+
+        case '9':
+            cyclePState(8);
+            refreshScreen();
+            break;
+
+        case '0':
+            cyclePState(9);
+            refreshScreen();
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Screen to view initialization of hardware before operating
+void renderOperationInit(void) {
+    unsigned char temporaryResult;
+    unsigned char temporaryByte;
+
+    displayPage("SNSR_Base:      ",
+                "SNSR_Tire1:     ",
+                "SNSR_Tire2:     ",
+                "                ");
+
+    // Keep track of any failed initializations
+    successfullyInitialized = true;
+    completedInitialization = false;
+
+    // Request the status of the sensors and retrieve result of Sensor_Base
+    temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_STATUS_SENSORS, &temporaryByte);
+
+    // Throw an error if UART communication was unsuccessful
+    UART_Request_Error_Handling_Not_Recursive(temporaryResult, " INITRQ_SENSORS ");
+
+    // Print the result of the initialization onto the LCD
+    lcd_set_ddram_addr(LCD_LINE1_ADDR + 12) // Put the cursor at 4 slots before the end
+
+    // Display the result of the initialization of the base sensor
+    if (temporaryByte == MSG_A2P_SUCCESS) {
+        printf("GOOD");
+    } else {
+        successfullyInitialized = false;
+        if (temporaryByte == MSG_A2P_FAILED) {
+            printf("FAIL");
+        } else {
+            printf(" ERR");
+        }
+    }
+
+    // Retrieve the status of Sensor_Tire1
+    temporaryResult = UART_Read(&temporaryByte);
+
+    // Throw an error if UART communication fails
+    UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RD_SENSOR_TIRE1 ");
+
+    // Display the result on the second line of the screen
+    lcd_set_ddram_addr(LCD_LINE2_ADDR + 12); // Put the cursor at 4 slots before the end
+
+    if (temporaryByte == MSG_A2P_SUCCESS) {
+        printf("GOOD");
+    } else {
+        successfullyInitialized = false;
+        if (temporaryByte == MSG_A2P_FAILED) {
+            printf("FAIL");
+        } else {
+            printf(" ERR");
+        }
+    }
+
+    // Retrieve the status of Sensor_Tire2
+    temporaryResult = UART_Read(&temporaryByte);
+
+    // Throw an error if UART communication fails
+    UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RD_SENSOR_TIRE2 ");
+
+    // Display the result on the third line of the screen
+    lcd_set_ddram_addr(LCD_LINE3_ADDR + 12);
+
+    if (temporaryByte == MSG_A2P_SUCCESS) {
+        printf("GOOD");
+    } else {
+        successfullyInitialized = false;
+        if (temporaryByte == MSG_A2P_FAILED) {
+            printf("FAIL");
+        } else {
+            printf(" ERR");
+        }
+    }
+
+    // Initialization complete
+    completedInitialization = true;
+
+    // Give the option to continue or return depending on successful initialization
+    lcd_set_ddram_addr(LCD_LINE4_ADDR);
+
+    if (!successfullyInitialized) {
+        printf("[D] Return      ");
+    } else {
+        printf("[D] Continue    ");
+    }
+}
+
+/* SNSR_BASE:
+ * SNSR_TIRE1:
+ * SNSR_TIRE2:
+ * [D] OK
+ */
+void keyOperationInit(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Only allow action if initialization is complete
+            if (completedInitialization) {
+                // Take the user back to the main menu if the initialization failed
+                if (successfullyInitialized) {
+                    setScreen(SC_LOAD_TIRES);
+                } else {
+                    setScreen(SC_MENU);
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void renderOperationSensorCheck(void) {
+    displayPage("SNSR_Base:  GOOD",
+                "SNSR_Tire1: GOOD",
+                "SNSR_Tire2: GOOD",
+                "[D] Continue    ");
+}
+
+void keyOperationSensorCheck(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Send signal to arduino to start with the parameters
+            UART_Write_With_Error_Handle(MSG_P2A_OP_DEBUG, "     OP_DBG     ");
+
+            for (unsigned char i = 0; i < 10; i++) {
+                UART_Write_With_Error_Handle(pstates[i], "     PSTATE     ");
+            }
+
+            loadMagazine(MAX_TIRE_CAPACITY);
+            setStatus(ST_OPERATE_START);
+            dbg = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Select how many tires are loaded into the robot
+void renderLoadTires(void) {
+    displayPage("                ",
+                "[*]Less  More[#]",
+                "[C] Start op.   ",
+                twoPassOperation ? "[D] Back  2-PASS" : "[D] Back        ");
+
+    // Display the number of tires to load
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+    printf("Loading %02d tires", loadedTires);
+}
+
+/* [*]Less  More[#]
+ * [C] Start Op.
+ * [D] Back
+ */
+void keyLoadTires(unsigned char key) {
+    switch (key) {
+        case '#':
+            // Increase the number of tires loaded
+            if (loadedTires < MAX_TIRE_CAPACITY) {
+                loadedTires++;
+                refreshScreen();
+            }
+
+            break;
+
+        case '*':
+            // Decrease the number of tires loaded
+            if (loadedTires > 0) {
+                loadedTires--;
+                refreshScreen();
+            }
+
+            break;
+
+        case 'B':
+            // Toggle between deploying as poles are found and mapping every pole first
+            twoPassOperation = !twoPassOperation;
+            refreshScreen();
+            break;
+
+        case 'C':
+            // Load the magazine and start the operation with desired amount of tires
+            loadMagazine(loadedTires);
+            setStatus(ST_OPERATE_START);
+
+            loadedTires = MAX_TIRE_CAPACITY;
+
+            break;
+
+        case 'D':
+            setStatus(ST_READY);
+            loadedTires = MAX_TIRE_CAPACITY;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Screen that displays while the robot is operating
+void renderOperating(void) {
+    PROBE_BEGIN(PROBE_RENDER_OPERATING);
+
+    displayPage("                ",
+                "                ",
+                "                ",
+                "[D] EMRGNCY STOP");
+
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+
+    // Display something based on the status
+    switch (getStatus()) {
+        case ST_OPERATE_START:
+            // Display the framework for initialization
+            displayPage(" Starting op... ",
+                        "                ",
+                        "                ",
+                        "                ");
+            break;
+
+        case ST_OPERATE_DRIVING:
+            // Display position while driving
+            printf("    DRIVING     ");
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+            // while (receivingData) { continue; }
+            // printf("TEST.C      2001");
+            // receivingData = true;
+            // // Request the position from the Arduino
+            // temporaryResult = UART_Request_Short(MSG_P2A_REQUEST_POSITION, &temporaryShort);
+
+            // // If the requested value was unsuccessful, throw an error
+            // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "REQUEST_POSITION");
+
+            // // Display the position on the LCD
+            // printf("Position:   %04d", temporaryShort);
+            // receivingData = false;
+            break;
+
+        case ST_OPERATE_MAPPING:
+            // Display message while the poles are mapped
+            printf("    MAPPING     ");
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+            break;
+
+        case ST_OPERATE_POLE_DETECTED:
+            // Display message while pole is detected`
+            printf(" POLE DETECTED  ");
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+            // while (receivingData) { continue; }
+            // // Request the number of tires found from the Arduino
+            // temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_TIRES_FOUND, &temporaryByte);
+
+            // // If the requested value was unsuccessful, throw an error
+            // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RQST_TIRES_FOUND");
+
+            // // Display the number of tires found on the LCD
+            // printf("Tires Found:  %02d", temporaryByte);
+
+            // receivingData = false;
+
+            break;
+
+        case ST_OPERATE_DEPLOYING_TIRE:
+            // Display tires remaining while robot is deploying
+            printf(" DEPLOYING TIRE ");
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+            // Warn that the tire may miss the pole
+            if (deployMisalignment > 0) {
+                printf("Misaligned %3dmm", deployMisalignment);
+            }
+
+            // while (receivingData) { continue; }
+            // receivingData = true;
+            // // Request the number of tires remaining from the Arduino
+            // temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_TIRES_REMAINING, &temporaryByte);
+
+            // // If the requested value was unsuccessful, throw an error
+            // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RQST_TIRES_REMNG");
+
+            // // Display the number of tires remaining on the LCD
+            // printf("Tire Ammo:    %02d", temporaryByte);
+            // receivingData = false;
+            break;
+
+        case ST_OPERATE_RETURN:
+            // Display the position while returning
+            printf("    RETURNING   ");
+            lcd_set_ddram_addr(LCD_LINE2_ADDR);
+
+            // while (receivingData) { continue; }
+            // receivingData = true;
+            // // Request the position from the Arduino
+            // temporaryResult = UART_Request_Short(MSG_P2A_REQUEST_POSITION, &temporaryShort);
+
+            // // If the requested value was unsuccessful, throw an error
+            // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "REQUEST_POSITION");
+
+            // // Display the position on the LCD
+            // printf("Position:   %04d", temporaryShort);
+            // receivingData = false;
+            break;
+
+        default:
+            break;
+    }
+
+    PROBE_END(PROBE_RENDER_OPERATING);
+}
+
+/* [D] Stop
+ */
+void keyOperating(unsigned char key) {
+    switch (key) {
+        case 'D':
+            UART_Write_With_Error_Handle(MSG_P2A_STOP, "      STOP      ");
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Handles the emergency stop and the messages from the Arduino while operating
+void eventOperating(Event *event) {
+    unsigned char temporaryResult;
+    unsigned char temporaryByte;
+
+    // If the emergency stop button is pressed, stop operating
+    if (event->type == EV_ESTOP) {
+        finishOperation();
+        return;
+    }
+
+    // Advance a tire towards its drop point a slice at a time between messages
+    if (event->type == EV_TICK) {
+        continueDeployment();
+        return;
+    }
+
+    // Handle messages from the Arduino
+    if (event->type == EV_UART_RX) {
+        messageFromArduino = event->data;
+
+        switch (messageFromArduino) {
+
+            case MSG_A2P_DRIVING:
+            // Set the status of the robot to driving and refresh the screen
+                setStatus(ST_OPERATE_DRIVING);
+                refreshScreen();
+                break;
+
+            case MSG_A2P_MAPPING:
+            // Set the status of the robot to mapping and refresh the screen
+                setStatus(ST_OPERATE_MAPPING);
+                refreshScreen();
+                break;
+
+            case MSG_A2P_RETURNING:
+            // Set the status of the robot to returning and refresh the screen
+                setStatus(ST_OPERATE_RETURN);
+                refreshScreen();
+                break;
+
+            case MSG_A2P_POLE_DETECTED:
+            // Set the status when a pole is detected
+                setStatus(ST_OPERATE_POLE_DETECTED);
+                break;
+
+            case MSG_A2P_PREPARE_DEPLOY:
+            // Push the next tire up to its drop point while the robot is still aligning (continues a pre-roll
+            // already in progress)
+                prepareDeployment();
+                break;
+
+            case MSG_A2P_DEPLOY_STEPPER:
+            // Set the status to deploying a tire
+                setStatus(ST_OPERATE_DEPLOYING_TIRE);
+                break;
+
+            case MSG_A2P_COMPLETE_OP:
+            // Complete the operation on the robot
+                temporaryResult = UART_Read(&(CURRENT_OPERATION.totalSuppliedTires));
+                UART_ErrorHandleRead(temporaryResult);
+
+                temporaryResult = UART_Read(&(CURRENT_OPERATION.totalNumberOfPoles));
+                UART_ErrorHandleRead(temporaryResult);
+
+                for (unsigned char i = 0; i < 10; i++) {
+                    temporaryResult = UART_Read(&(CURRENT_OPERATION.tiresDeployedOnPole[i]));
+                    UART_ErrorHandleRead(temporaryResult);
+                }
+
+                for (unsigned char i = 0; i < 10; i++) {
+                    temporaryResult = UART_Read(&(CURRENT_OPERATION.tiresOnPoleAfterOperation[i]));
+                    UART_ErrorHandleRead(temporaryResult);
                 }
+
+                for (unsigned char i = 0; i < 10; i++) {
+                    temporaryResult = UART_Read_Short(&(CURRENT_OPERATION.distanceOfPole[i]));
+                    UART_ErrorHandleRead(temporaryResult);
+                }
+
+                finishOperation();
+                break;
+
+            case MSG_A2P_SENSOR_TIMEOUT:
+            // Throw an error if the sensor times out
+                setStatus(ST_ERROR);
+                setScreen(SC_SENSOR_TIMEOUT_ERROR);
+                break;
+
+            case MSG_A2P_UART_READ_TIMEOUT:
+            // Throw an error if the Arduino stopped waiting for the rest of a message
+                setStatus(ST_ERROR);
+                setScreen(SC_UART_READ_TIMEOUT_ERROR);
+                break;
+
+            case MSG_A2P_ADJUST_AWAY:
+            // Move away from the pole for a pulse proportional to the error that follows
+                temporaryResult = UART_Read(&temporaryByte);
+                UART_ErrorHandleRead(temporaryResult);
+
+                nudgeMotors(MOTOR_AWAY, temporaryByte);
+                UART_Write_With_Error_Handle(MSG_P2A_ADJUSTMENT_COMPLETE, "  ADJ_COMPLETE  ")
+                break;
+
+            case MSG_A2P_ADJUST_TOWARDS:
+            // Move towards the pole for a pulse proportional to the error that follows
+                temporaryResult = UART_Read(&temporaryByte);
+                UART_ErrorHandleRead(temporaryResult);
+
+                nudgeMotors(MOTOR_TOWARDS, temporaryByte);
+                UART_Write_With_Error_Handle(MSG_P2A_ADJUSTMENT_COMPLETE, "  ADJ_COMPLETE  ")
+                break;
+
+            case MSG_A2P_ALIGNED:
+            // The Arduino aligned itself with the pole, a deployment request follows
+                deployMisalignment = 0;
+                break;
+
+            case MSG_A2P_ALIGN_TIMEOUT:
+            // The Arduino ran out of time to align, the error it stopped at and a deployment request follow
+                temporaryResult = UART_Read(&deployMisalignment);
+                UART_ErrorHandleRead(temporaryResult);
+                break;
+
+            default:
+            // Invalid arduino message, throw error
+                setStatus(ST_ERROR);
+                setScreen(SC_UNHANDLED_ARDUINO_MESSAGE_ERROR);
+
+                lcd_set_ddram_addr(LCD_LINE3_ADDR);
+                printf("%X", messageFromArduino);
+                break;
+        }
+
+        // The rest of the message was read directly, so listen for the next message
+        if (getScreen() == SC_OPERATING) {
+            UART_Listen();
+        }
+    }
+}
+
+// Termination screen when the operation is complete
+void renderTerminated(void) {
+    displayPage("                ",
+                "                ",
+                "[C] View Results",
+                "[D] Finish Op.  ");
+
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+
+    // Display a termination message dependant on whether the emergency stop was pressed
+    if (emergency_stop_pressed) {
+        printf(" Op. Terminated ");
+        lcd_set_ddram_addr(LCD_LINE2_ADDR);
+        printf("EMERGNCY STOPPED");
+    } else {
+        printf(" Op. Completed  ");
+    }
+}
+
+/* [C] View Results
+ * [D] Finish Op.
+ */
+void keyTerminated(unsigned char key) {
+    switch (key) {
+        case 'C':
+            // View the results of the operation
+            page = 0;
+            setScreen(SC_VIEW_RESULTS);
+            break;
+
+        case 'D':
+            // Prompt the user to save
+            setScreen(SC_SAVE);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Screen to view the results of the operation (or viewing them through the logs)
+void renderViewResults(void) {
+    // Display menu framework (max pages is 2 + number of poles detected)
+    displayMenuPage("                ",
+                    "                ",
+                    "                ",
+                    page > 0, page < (CURRENT_OPERATION.totalNumberOfPoles + 1));
+
+    // Page 1 (indexed at 0): displays temporal information
+    if (page == 0) {
+        // Display the month, day and year
+        lcd_set_ddram_addr(LCD_LINE1_ADDR);
+        printf("Day: %s %02X/19", months[CURRENT_OPERATION.startTime[4]], CURRENT_OPERATION.startTime[3]);
+        // Display the time the operation started
+        lcd_set_ddram_addr(LCD_LINE2_ADDR);
+        printf("Time:   %02X:%02X:%02X", CURRENT_OPERATION.startTime[2], CURRENT_OPERATION.startTime[1], CURRENT_OPERATION.startTime[0]);
+        // Display the duration of the operation
+        lcd_set_ddram_addr(LCD_LINE3_ADDR);
+        printf("Duration:  %02d:%02d", CURRENT_OPERATION.duration / 60, CURRENT_OPERATION.duration % 60);
+
+    // Page 2 (indexed at 1): displays information about the total number of poles/tires
+    } else if (page == 1) {
+        // Display the total number of poles
+        lcd_set_ddram_addr(LCD_LINE1_ADDR);
+        printf("Poles Found:  %02d", CURRENT_OPERATION.totalNumberOfPoles);
+        // Display the total number of supplied tires
+        lcd_set_ddram_addr(LCD_LINE2_ADDR);
+        printf("Total Tires:  %02d", CURRENT_OPERATION.totalSuppliedTires);
+
+    // Page 3-12 (indexed at 2-11): displays information about specific poles
+    } else if (page > 1 && page < CURRENT_OPERATION.totalNumberOfPoles + 2) {
+        // Display the pole being described
+        lcd_set_ddram_addr(LCD_LINE1_ADDR);
+        printf("Pole #%02d  %03d cm", page - 1, CURRENT_OPERATION.distanceOfPole[page - 2]);
+        // Display the number of tires stacked onto the pole
+        lcd_set_ddram_addr(LCD_LINE2_ADDR);
+        printf("Tires Stacked: %01d", CURRENT_OPERATION.tiresDeployedOnPole[page - 2]);
+        // Display the number of tires on the pole after the operation
+        lcd_set_ddram_addr(LCD_LINE3_ADDR);
+        printf("Tires on Pole: %01d", CURRENT_OPERATION.tiresOnPoleAfterOperation[page - 2]);
+    }
+}
+
+/* <[*] BCK[0] [#]>
+ */
+void keyViewResults(unsigned char key) {
+    switch (key) {
+        case '*':
+            // Go to the previous page
+            if (page > 0) {
+                page--;
+                refreshScreen();
+            }
+            break;
+
+        case '0':
+            // Return to the previous screen
+            if (getStatus() == ST_READY) {
+                page = 0;
+                setScreen(SC_LOGS_VIEW);
+            } else {
+                setScreen(SC_TERMINATED);
             }
-            printf("   ");
             break;
 
-        case SC_OPERATION_SENSOR_CHECK:
-            displayPage("SNSR_Base:  GOOD",
-                        "SNSR_Tire1: GOOD",
-                        "SNSR_Tire2: GOOD",
-                        "[D] Continue    ");
+        case '#':
+            // Go to the next page
+            if (page < (CURRENT_OPERATION.totalNumberOfPoles + 1)) {
+                page++;
+                refreshScreen();
+            }
             break;
 
-        case SC_OPERATION_INIT:
-        // Screen to view initialization of hardware before operating
-            displayPage("SNSR_Base:      ",
-                        "SNSR_Tire1:     ",
-                        "SNSR_Tire2:     ",
-                        "                ");
+        default:
+            break;
+    }
+}
 
-            // Keep track of any failed initializations
-            successfullyInitialized = true;
-            completedInitialization = false;
+// Ask user if they would like to save operation or continue without saving
+void renderSave(void) {
+    displayPage("Save operation?     ",
+                "[B] Save            ",
+                "[C] Don't Save      ",
+                "[D] Back            ");
+}
 
-            // Request the status of the sensors and retrieve result of Sensor_Base
-            temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_STATUS_SENSORS, &temporaryByte);
+/* [B] Save
+ * [C] Don't Save
+ * [D] Back
+ */
+void keySave(unsigned char key) {
+    switch (key) {
+        case 'B':
+            // Go to save selection screen
+            page = 0;
+            setScreen(SC_SELECT_SAVE_SLOT);
+            break;
 
-            // Throw an error if UART communication was unsuccessful
-            UART_Request_Error_Handling_Not_Recursive(temporaryResult, " INITRQ_SENSORS ");
+        case 'C':
+            // Return to main menu
+            setStatus(ST_READY);
+            break;
 
-            // Print the result of the initialization onto the LCD
-            lcd_set_ddram_addr(LCD_LINE1_ADDR + 12) // Put the cursor at 4 slots before the end
+        case 'D':
+            // Go back to termination screen
+            setScreen(SC_TERMINATED);
+            break;
 
-            // Display the result of the initialization of the base sensor
-            if (temporaryByte == MSG_A2P_SUCCESS) {
-                printf("GOOD");
+        default:
+            break;
+    }
+}
+
+// Display menu page for user to select slot to save the operation
+void renderSelectSaveSlot(void) {
+    // Display the menu framework (max pages holds up to MAX_LOGS entries)
+    displayMenuPage("                ",
+                    "                ",
+                    "                ",
+                    page > 0, page < (MAX_LOGS - 1) / 3);
+
+    // Display the slots available and add "USED" if the slot is taken
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+    printf("[A] Slot %02d %s", (page * 3) + 1, getLogSlot(page * 3) == SLOT_USED ? "USED" : "    ");
+    lcd_set_ddram_addr(LCD_LINE2_ADDR);
+    printf("[B] Slot %02d %s", (page * 3) + 2, getLogSlot((page * 3) + 1) == SLOT_USED ? "USED" : "    ");
+    lcd_set_ddram_addr(LCD_LINE3_ADDR);
+    printf("[C] Slot %02d %s", (page * 3) + 3, getLogSlot((page * 3) + 2) == SLOT_USED ? "USED" : "    ");
+}
+
+/* [A] Slot #<1, 4, 7, 10, 13, 16>
+ * [B] Slot #<2, 5, 8, 11, 14>
+ * [C] Slot #<3, 6, 9, 12, 15>
+ * <[*] BCK[0] [#]>
+ */
+void keySelectSaveSlot(unsigned char key) {
+    switch (key) {
+        case '*':
+            // Go to the previous page
+            if (page > 0) {
+                page--;
+                refreshScreen();
+            }
+            break;
+
+        case '0':
+            // Return to the save screen
+            setScreen(SC_SAVE);
+            break;
+
+        case '#':
+            // Go to the next page
+            if (page < ((MAX_LOGS - 1) / 3)) {
+                page++;
+                refreshScreen();
+            }
+            break;
+
+        case 'A':
+            // Save into the first row slot
+            if (getLogSlot(page * 3) == SLOT_USED) {
+                // If the slot is used, prompt user for verification to overwrite
+                setScreen(SC_OVERWRITE_LOG_VERIFICATION_1);
             } else {
-                successfullyInitialized = false;
-                if (temporaryByte == MSG_A2P_FAILED) {
-                    printf("FAIL");
+                lcd_home();
+                printf("K: %X", getLogSlot(page * 3));
+                // Try to save the operation into the logs and throw an error if failed
+                if (storeOperationIntoLogs(CURRENT_OPERATION, page * 3) == UNSUCCESSFUL) {
+                    setStatus(ST_ERROR);
+                    setScreen(SC_SAVE_OPERATION_ERROR);
                 } else {
-                    printf(" ERR");
+                    CURRENT_OPERATION.saveSlot = (page * 3) + 1;
+                    setScreen(SC_SAVE_COMPLETED);
                 }
             }
+            break;
 
-            // // Retrieve the status of Sensor_Tire1
-            // temporaryResult = UART_Read(&temporaryByte);
-
-            // // Throw an error if UART communication fails
-            // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RD_SENSOR_TIRE1 ");
-
-            // // Display the result on the second line of the screen
-            // lcd_set_ddram_addr(LCD_LINE2_ADDR + 12); // Put the cursor at 4 slots before the end
-
-            // if (temporaryByte == MSG_A2P_SUCCESS) {
-            //     printf("GOOD");
-            // } else {
-            //     successfullyInitialized = false;
-            //     if (temporaryByte == MSG_A2P_FAILED) {
-            //         printf("FAIL");
-            //     } else {
-            //         printf(" ERR");
-            //     }
-            // }
-
-            // // Retrieve the status of Sensor_Tire2
-            // temporaryResult = UART_Read(&temporaryByte);
-
-            // // Throw an error if UART communication fails
-            // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RD_SENSOR_TIRE@ ");
-
-            // // Display the result on the third line of the screen
-            // lcd_set_ddram_addr(LCD_LINE3_ADDR + 12);
-
-            // if (temporaryByte == MSG_A2P_SUCCESS) {
-            //     printf("GOOD");
-            // } else {
-            //     successfullyInitialized = false;
-            //     if (temporaryByte == MSG_A2P_FAILED) {
-            //         printf("FAIL");
-            //     } else {
-            //         printf(" ERR");
-            //     }
-            // }
-
-            lcd_set_ddram_addr(LCD_LINE2_ADDR + 12);
-            printf("GOOD");
-            // __delay_ms(5);
-            lcd_set_ddram_addr(LCD_LINE3_ADDR + 12);
-            printf("GOOD");
-            
-            // Initialization complete
-            completedInitialization = true;
-
-            // Give the option to continue or return depending on successful initialization
-            lcd_set_ddram_addr(LCD_LINE4_ADDR);
-
-            if (!successfullyInitialized) {
-                printf("[D] Return      ");
+        case 'B':
+            // Save into the second row slot
+            if (getLogSlot((page * 3) + 1) == SLOT_USED) {
+                // If the slot is used, prompt user for verification to overwrite
+                setScreen(SC_OVERWRITE_LOG_VERIFICATION_2);
             } else {
-                printf("[D] Continue    ");
+                // Try to save the operation into the logs and throw an error if failed
+                if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 1) == UNSUCCESSFUL) {
+                    setStatus(ST_ERROR);
+                    setScreen(SC_SAVE_OPERATION_ERROR);
+                } else {
+                    CURRENT_OPERATION.saveSlot = (page * 3) + 2;
+                    setScreen(SC_SAVE_COMPLETED);
+                }
             }
             break;
 
-        case SC_LOAD_TIRES:
-        // Select how many tires are loaded into the robot
-            displayPage("                ",
-                        "[*]Less  More[#]",
-                        "[C] Start op.   ",
-                        "[D] Back        ");
+        case 'C':
+            // Save into the third row slot
+            if (getLogSlot((page * 3) + 2) == SLOT_USED) {
+                // If the slot is used, prompt user for verification to overwrite
+                setScreen(SC_OVERWRITE_LOG_VERIFICATION_3);
+            } else {
+                // Try to save the operation into the logs and throw an error if failed
+                if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 2) == UNSUCCESSFUL) {
+                    setStatus(ST_ERROR);
+                    setScreen(SC_SAVE_OPERATION_ERROR);
+                } else {
+                    CURRENT_OPERATION.saveSlot = (page * 3) + 3;
+                    setScreen(SC_SAVE_COMPLETED);
+                }
+            }
             break;
 
-        case SC_OPERATING:
-        // Screen that displays while the robot is operating
-            displayPage("                ",
-                        "                ",
-                        "                ",
-                        "[D] EMRGNCY STOP");
+        default:
+            break;
+    }
+}
 
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
+// Prompt that appear if the user selects a slot on the first row that is already used
+void renderOverwriteLogVerification1(void) {
+    displayPage("                ",
+                "Overwrite?      ",
+                "[C] No          ",
+                "[D] Yes         ");
+
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+    printf("Slot %02d in use. ", (page * 3) + 1);
+}
+
+/* [C] No
+ * [D] Yes
+ */
+void keyOverwriteLogVerification1(unsigned char key) {
+    switch (key) {
+        case 'C':
+            // Return to save slot selection screen
+            setScreen(SC_SELECT_SAVE_SLOT);
+            break;
 
-            // Display something based on the status
-            switch (getStatus()) {
-                case ST_OPERATE_START:
-                    // Display the framework for initialization
-                    displayPage(" Starting op... ",
-                                "                ",
-                                "                ",
-                                "                ");
-                    break;
-
-                case ST_OPERATE_DRIVING:
-                    // Display position while driving
-                    printf("    DRIVING     ");
-                    lcd_set_ddram_addr(LCD_LINE2_ADDR);
-
-                    // while (receivingData) { continue; }
-                    // printf("TEST.C      2001");
-                    // receivingData = true;
-                    // // Request the position from the Arduino
-                    // temporaryResult = UART_Request_Short(MSG_P2A_REQUEST_POSITION, &temporaryShort);
-
-                    // // If the requested value was unsuccessful, throw an error
-                    // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "REQUEST_POSITION");
-
-                    // // Display the position on the LCD
-                    // printf("Position:   %04d", temporaryShort);
-                    // receivingData = false;
-                    break;
-
-                case ST_OPERATE_POLE_DETECTED:
-                    // Display message while pole is detected`
-                    printf(" POLE DETECTED  ");
-                    lcd_set_ddram_addr(LCD_LINE2_ADDR);
-
-                    // while (receivingData) { continue; }
-                    // // Request the number of tires found from the Arduino
-                    // temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_TIRES_FOUND, &temporaryByte);
-
-                    // // If the requested value was unsuccessful, throw an error
-                    // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RQST_TIRES_FOUND");
-
-                    // // Display the number of tires found on the LCD
-                    // printf("Tires Found:  %02d", temporaryByte);
-
-                    // receivingData = false;
-
-                    break;
-
-                case ST_OPERATE_DEPLOYING_TIRE:
-                    // Display tires remaining while robot is deploying
-                    printf(" DEPLOYING TIRE ");
-                    lcd_set_ddram_addr(LCD_LINE2_ADDR);
-
-                    // while (receivingData) { continue; }
-                    // receivingData = true;
-                    // // Request the number of tires remaining from the Arduino
-                    // temporaryResult = UART_Request_Byte(MSG_P2A_REQUEST_TIRES_REMAINING, &temporaryByte);
-
-                    // // If the requested value was unsuccessful, throw an error
-                    // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "RQST_TIRES_REMNG");
-
-                    // // Display the number of tires remaining on the LCD
-                    // printf("Tire Ammo:    %02d", temporaryByte);
-                    // receivingData = false;
-                    break;
-                    
-                case ST_OPERATE_RETURN:
-                    // Display the position while returning
-                    printf("    RETURNING   ");
-                    lcd_set_ddram_addr(LCD_LINE2_ADDR);
-
-                    // while (receivingData) { continue; }
-                    // receivingData = true;
-                    // // Request the position from the Arduino
-                    // temporaryResult = UART_Request_Short(MSG_P2A_REQUEST_POSITION, &temporaryShort);
-
-                    // // If the requested value was unsuccessful, throw an error
-                    // UART_Request_Error_Handling_Not_Recursive(temporaryResult, "REQUEST_POSITION");
-
-                    // // Display the position on the LCD
-                    // printf("Position:   %04d", temporaryShort);
-                    // receivingData = false;
-                    break;
-                    
-                default:
-                    break;
+        case 'D':
+            // Try to save the operation into the logs and throw an error if failed
+            if (storeOperationIntoLogs(CURRENT_OPERATION, page * 3) == UNSUCCESSFUL) {
+                setStatus(ST_ERROR);
+                setScreen(SC_SAVE_OPERATION_ERROR);
+            } else {
+                CURRENT_OPERATION.saveSlot = (page * 3) + 1;
+                setScreen(SC_SAVE_COMPLETED);
             }
             break;
 
-        case SC_TERMINATED:
-        // Termination screen when the operation is complete
-            displayPage("                ",
-                        "                ",
-                        "[C] View Results",
-                        "[D] Finish Op.  ");
+        default:
+            break;
+    }
+}
 
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
+// Prompt that appear if the user selects a slot on the second row that is already used
+void renderOverwriteLogVerification2(void) {
+    displayPage("                ",
+                "Overwrite?      ",
+                "[C] No          ",
+                "[D] Yes         ");
+
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+    printf("Slot %02d in use. ", (page * 3) + 2);
+}
+
+/* [C] No
+ * [D] Yes
+ */
+void keyOverwriteLogVerification2(unsigned char key) {
+    switch (key) {
+        case 'C':
+            // Return to save slot selection screen
+            setScreen(SC_SELECT_SAVE_SLOT);
+            break;
 
-            // Display a termination message dependant on whether the emergency stop was pressed
-            if (emergency_stop_pressed) {
-                printf(" Op. Terminated ");
-                lcd_set_ddram_addr(LCD_LINE2_ADDR);
-                printf("EMERGNCY STOPPED");
+        case 'D':
+            // Try to save the operation into the logs and throw an error if failed
+            if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 1) == UNSUCCESSFUL) {
+                setStatus(ST_ERROR);
+                setScreen(SC_SAVE_OPERATION_ERROR);
             } else {
-                printf(" Op. Completed  ");
+                CURRENT_OPERATION.saveSlot = (page * 3) + 2;
+                setScreen(SC_SAVE_COMPLETED);
             }
+            break;
 
+        default:
             break;
+    }
+}
 
-        case SC_VIEW_RESULTS:
-            // Screen to view the results of the operation (or viewing them through the logs)
+// Prompt that appear if the user selects a slot on the third row that is already used
+void renderOverwriteLogVerification3(void) {
+    displayPage("                ",
+                "Overwrite?      ",
+                "[C] No          ",
+                "[D] Yes         ");
 
-            // Display menu framework (max pages is 2 + number of poles detected)
-            displayMenuPage("                ",
-                            "                ",
-                            "                ",
-                            page > 0, page < (CURRENT_OPERATION.totalNumberOfPoles + 1));
+    lcd_set_ddram_addr(LCD_LINE1_ADDR);
+    printf("Slot %02d in use. ", (page * 3) + 3);
+}
 
-            // Page 1 (indexed at 0): displays temporal information
-            if (page == 0) {
-                // Display the month, day and year
-                lcd_set_ddram_addr(LCD_LINE1_ADDR);
-                printf("Day: %s %02X/19", months[CURRENT_OPERATION.startTime[4]], CURRENT_OPERATION.startTime[3]);
-                // Display the time the operation started
-                lcd_set_ddram_addr(LCD_LINE2_ADDR);
-                printf("Time:   %02X:%02X:%02X", CURRENT_OPERATION.startTime[2], CURRENT_OPERATION.startTime[1], CURRENT_OPERATION.startTime[0]);
-                // Display the duration of the operation
-                lcd_set_ddram_addr(LCD_LINE3_ADDR);
-                printf("Duration:  %02d:%02d", CURRENT_OPERATION.duration / 60, CURRENT_OPERATION.duration % 60);
-
-            // Page 2 (indexed at 1): displays information about the total number of poles/tires
-            } else if (page == 1) {
-                // Display the total number of poles
-                lcd_set_ddram_addr(LCD_LINE1_ADDR);
-                printf("Poles Found:  %02d", CURRENT_OPERATION.totalNumberOfPoles);
-                // Display the total number of supplied tires
-                lcd_set_ddram_addr(LCD_LINE2_ADDR);
-                printf("Total Tires:  %02d", CURRENT_OPERATION.totalSuppliedTires);
-
-            // Page 3-12 (indexed at 2-11): displays information about specific poles
-            } else if (page > 1 && page < CURRENT_OPERATION.totalNumberOfPoles + 2) {
-                // Display the pole being described
-                lcd_set_ddram_addr(LCD_LINE1_ADDR);
-                printf("Pole #%02d  %03d cm", page - 1, CURRENT_OPERATION.distanceOfPole[page - 2]);
-                // Display the number of tires stacked onto the pole
-                lcd_set_ddram_addr(LCD_LINE2_ADDR);
-                printf("Tires Stacked: %01d", CURRENT_OPERATION.tiresDeployedOnPole[page - 2]);
-                // Display the number of tires on the pole after the operation
-                lcd_set_ddram_addr(LCD_LINE3_ADDR);
-                printf("Tires on Pole: %01d", CURRENT_OPERATION.tiresOnPoleAfterOperation[page - 2]);
+/* [C] No
+ * [D] Yes
+ */
+void keyOverwriteLogVerification3(unsigned char key) {
+    switch (key) {
+        case 'C':
+            // Return to save slot selection screen
+            setScreen(SC_SELECT_SAVE_SLOT);
+            break;
+
+        case 'D':
+            // Try to save the operation into the logs and throw an error if failed
+            if (storeOperationIntoLogs(CURRENT_OPERATION, (page * 3) + 2) == UNSUCCESSFUL) {
+                setStatus(ST_ERROR);
+                setScreen(SC_SAVE_OPERATION_ERROR);
+            } else {
+                CURRENT_OPERATION.saveSlot = (page * 3) + 3;
+                setScreen(SC_SAVE_COMPLETED);
             }
             break;
 
-        case SC_SAVE:
-        // Ask user if they would like to save operation or continue without saving
-            displayPage("Save operation?     ",
-                        "[B] Save            ",
-                        "[C] Don't Save      ",
-                        "[D] Back            ");
+        default:
             break;
+    }
+}
 
-        case SC_SELECT_SAVE_SLOT:
-        // Display menu page for user to select slot to save the operation
+// Confirmation of save prompt
+void renderSaveCompleted(void) {
+    displayPage("Saved operation ",
+                "successfully in ",
+                "                ",
+                "[D] OK          ");
 
-            // Display the menu framework (max pages holds up to MAX_LOGS entries)
-            displayMenuPage("                ",
-                            "                ",
-                            "                ",
-                            page > 0, page < (MAX_LOGS - 1) / 3);
+    lcd_set_ddram_addr(LCD_LINE3_ADDR);
+    printf("    slot %02d     ", CURRENT_OPERATION.saveSlot);
+}
 
-            // Display the slots available and add "USED" if the slot is taken
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
-            printf("[A] Slot %02d %s", (page * 3) + 1, getLogSlot(page * 3) == SLOT_USED ? "USED" : "    ");
-            lcd_set_ddram_addr(LCD_LINE2_ADDR);
-            printf("[B] Slot %02d %s", (page * 3) + 2, getLogSlot((page * 3) + 1) == SLOT_USED ? "USED" : "    ");
-            lcd_set_ddram_addr(LCD_LINE3_ADDR);
-            printf("[C] Slot %02d %s", (page * 3) + 3, getLogSlot((page * 3) + 2) == SLOT_USED ? "USED" : "    ");
+/* [D] OK
+ */
+void keySaveCompleted(unsigned char key) {
+    switch (key) {
+        case 'D':
+            setStatus(ST_READY);
+            break;
 
+        default:
             break;
+    }
+}
 
-        case SC_OVERWRITE_LOG_VERIFICATION_1:
-        // Prompt that appear if the user selects a slot on the first row that is already used
-            displayPage("                ",
-                        "Overwrite?      ",
-                        "[C] No          ",
-                        "[D] Yes         ");
+// Display unsuccessful retrieval of operation error
+void renderLogViewError(void) {
+    displayPage("     ERROR      ",
+                " Unable to read ",
+                " operation data ",
+                "[D] OK          ");
+}
 
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
-            printf("Slot %02d in use. ", (page * 3) + 1);
+/* [D] OK
+ */
+void keyLogViewError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the main menu
+            setStatus(ST_READY);
             break;
 
-        case SC_OVERWRITE_LOG_VERIFICATION_2:
-        // Prompt that appear if the user selects a slot on the second row that is already used
-            displayPage("                ",
-                        "Overwrite?      ",
-                        "[C] No          ",
-                        "[D] Yes         ");
-
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
-            printf("Slot %02d in use. ", (page * 3) + 2);
+        default:
             break;
+    }
+}
 
-        case SC_OVERWRITE_LOG_VERIFICATION_3:
-        // Prompt that appear if the user selects a slot on the third row that is already used
-            displayPage("                ",
-                        "Overwrite?      ",
-                        "[C] No          ",
-                        "[D] Yes         ");
+// Display invalid state error
+void renderInvalidStateError(void) {
+    displayPage("     ERROR      ",
+                " Invalid state  ",
+                "                ",
+                "[D] OK          ");
+}
 
-            lcd_set_ddram_addr(LCD_LINE1_ADDR);
-            printf("Slot %02d in use. ", (page * 3) + 3);
+/* [D] OK
+ */
+void keyInvalidStateError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the main menu
+            setStatus(ST_READY);
             break;
 
-        case SC_SAVE_COMPLETED:
-        // Confirmation of save prompt
-            displayPage("Saved operation ",
-                        "successfully in ",
-                        "                ",
-                        "[D] OK          ");
-
-            lcd_set_ddram_addr(LCD_LINE3_ADDR);
-            printf("    slot %02d     ", CURRENT_OPERATION.saveSlot);
+        default:
             break;
+    }
+}
+
+// Display invalid screen error
+void renderInvalidScreenError(void) {
+    displayPage("     ERROR      ",
+                " Invalid screen ",
+                "                ",
+                "[D] OK          ");
+}
 
-        case SC_LOG_VIEW_ERROR:
-        // Display unsuccessful retrieval of operation error
-            displayPage("     ERROR      ",
-                        " Unable to read ",
-                        " operation data ",
-                        "[D] OK          ");
+/* [D] OK
+ */
+void keyInvalidScreenError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the main menu
+            setStatus(ST_READY);
             break;
 
-        case SC_INVALID_SCREEN_ERROR:
-        // Display invalid screen error
-            displayPage("     ERROR      ",
-                        " Invalid screen ",
-                        "                ",
-                        "[D] OK          ");
+        default:
             break;
+    }
+}
 
-        case SC_INVALID_STATE_ERROR:
-        // Display invalid state error
-            displayPage("     ERROR      ",
-                        " Invalid state  ",
-                        "                ",
-                        "[D] OK          ");
+// Display saving operation error
+void renderSaveOperationError(void) {
+    displayPage("     ERROR      ",
+                " Unable to save ",
+                "  the operation ",
+                "[D] OK          ");
+}
+
+/* [D] OK
+ */
+void keySaveOperationError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the operation complete screen
+            setStatus(ST_COMPLETED_OP);
             break;
 
-        case SC_SAVE_OPERATION_ERROR:
-        // Display saving operation error
-            displayPage("     ERROR      ",
-                        " Unable to save ",
-                        "  the operation ",
-                        "[D] OK          ");
+        default:
             break;
+    }
+}
 
-        case SC_UNHANDLED_ARDUINO_MESSAGE_ERROR:
-        // Display unhandled arduino message error
-            displayPage("     ERROR      ",
-                        " Unhandled code ",
-                        "                ",
-                        "[D] OK          ");
+// Display unhandled arduino message error
+void renderUnhandledArduinoMessageError(void) {
+    displayPage("     ERROR      ",
+                " Unhandled code ",
+                "                ",
+                "[D] OK          ");
+}
+
+/* [D] OK
+ */
+void keyUnhandledArduinoMessageError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the main menu
+            setStatus(ST_READY);
             break;
 
-        case SC_UART_INIT_ERROR:
-        // Display UART initialization error
-            displayPage("     ERROR      ",
-                        "UART init failed",
-                        "                ",
-                        "[D] OK          ");
+        default:
             break;
+    }
+}
 
-        case SC_SEND_ARDUINO_MESSAGE_ERROR:
-        // Display send arduino message error
-            displayPage("     ERROR      ",
-                        "Send code failed",
-                        "                ",
-                        "[D] OK          ");
+// Display send arduino message error
+void renderSendArduinoMessageError(void) {
+    displayPage("     ERROR      ",
+                "Send code failed",
+                "                ",
+                "[D] OK          ");
+}
+
+/* [D] OK
+ */
+void keySendArduinoMessageError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the main menu
+            setStatus(ST_READY);
             break;
 
-        case SC_UART_READ_TIMEOUT_ERROR:
-        // Display UART read timeout error
-            displayPage("     ERROR      ",
-                        "UART read timed ",
-                        "      out       ",
-                        "[D] OK          ");
+        default:
             break;
+    }
+}
+
+// Display UART initialization error
+void renderUartInitError(void) {
+    displayPage("     ERROR      ",
+                "UART init failed",
+                "                ",
+                "[D] OK          ");
+}
+
+/* [D] Reinitialize
+ */
+void keyUartInitError(unsigned char key) {
+    switch (key) {
+        case 'D':
+
+            lcd_set_ddram_addr(LCD_LINE3_ADDR);
+            printf(" Reinitializing ");
+            // Reinitialize UART
+            if (UART_Init(9600) == SUCCESSFUL) {
+                setStatus(ST_STANDBY);
+            } else {
+                // Wait some time before able to reinitialize
+                __delay_ms(100);
+                refreshScreen();
+            }
 
-        case SC_SENSOR_TIMEOUT_ERROR:
-        // Display UART read timeout error
-            displayPage("     ERROR      ",
-                        "Sensor timed out",
-                        "                ",
-                        "[D] OK          ");
             break;
 
         default:
-        // For an invalid screen, throw an error
-            // Set status to ST_ERROR
-            CURRENT_STATUS = ST_ERROR;
-            
-            // Set screen to SC_INVALID_SCREEN_ERROR
-            CURRENT_SCREEN = SC_INVALID_SCREEN_ERROR;
-            
-            // Display invalid screen error
-            displayPage("     ERROR      ",
-                        " Invalid screen ",
-                        "                ",
-                        "[D] OK          ");
             break;
     }
 }
 
-void refreshScreen(void) {
-    setScreen(getScreen());
+// Display UART read timeout error
+void renderUartReadTimeoutError(void) {
+    displayPage("     ERROR      ",
+                "UART read timed ",
+                "      out       ",
+                "[D] OK          ");
 }
 
-void cyclePState(unsigned char pNum) {
-    switch (pstates[pNum]) {
-        case PS_None:
-            pstates[pNum] = PS_0T;
+/* [D] OK
+ */
+void keyUartReadTimeoutError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the main menu
+            setStatus(ST_READY);
             break;
 
-        case PS_0T:
-            pstates[pNum] = PS_1T;
+        default:
             break;
+    }   
+}
 
-        case PS_1T:
-            pstates[pNum] = PS_2T;
+// Display UART read timeout error
+void renderSensorTimeoutError(void) {
+    displayPage("     ERROR      ",
+                "Sensor timed out",
+                "                ",
+                "[D] OK          ");
+}
+
+/* [D] OK
+ */
+void keySensorTimeoutError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Return to the main menu
+            setStatus(ST_READY);
             break;
 
-        case PS_2T:
-            pstates[pNum] = PS_None;
+        default:
+            break;
+    }   
+}
+
+// Display the emergency stop latch
+void renderEmergencyStopError(void) {
+    displayPage(" E-STOP LATCHED ",
+                "Actuators off   ",
+                "Release button  ",
+                "[D] OK          ");
+}
+
+/* [D] OK
+ */
+void keyEmergencyStopError(unsigned char key) {
+    switch (key) {
+        case 'D':
+            // Only clear the latch (in ST_READY) once the button is released
+            if (PORTBbits.RB0 == 0) {
+                break;
+            }
+            setStatus(ST_READY);
+            break;
+
+        default:
             break;
     }
 }
 
 void activateEmergencyStop(void) {
-    // Disable all actuators and display a terminated screen
+    // Follows up an emergency stop once the interrupt has cut the actuators
 
     // Tell arduino to stop DC motors
     UART_Write_With_Error_Handle(MSG_P2A_STOP, "      STOP      ");
 
-    // Disable stepper motor
+    // Keep the stepper motor disabled
     STEPPER_EN = 0;
 }
 
+// Called every millisecond from the interrupt handler
+void repeatHeldKey(void) {
+    if (heldKey == 0) {
+        return;
+    }
+
+    // The keypad data available line (RB1) stays high while the key is held
+    if (PORTBbits.RB1 == 0) {
+        heldKey = 0;
+        return;
+    }
+
+    // Post the key again every KEY_REPEAT_PERIOD_MS after the initial delay
+    heldKeyTime--;
+    if (heldKeyTime == 0) {
+        Event_Post(EV_KEY, heldKey);
+        heldKeyTime = KEY_REPEAT_PERIOD_MS;
+    }
+}
+
 // Interrupt Functions
-void __interrupt() interruptHandler(void){
-// Handles interrupts received from RB0 (emergency stop) and RB1 (keypad)
+void __interrupt(high_priority) emergencyStopHandler(void){
+// Handles RB0 (emergency stop) alone, so nothing can delay it. The actuators are cut within a few
+// microseconds of the button being pressed, even while the LCD or a low-priority interrupt is busy: the
+// vector is reached in 3 to 4 cycles, but XC8 first saves the registers and compiler temporaries the
+// handler uses, a few dozen cycles at 10 MIPS. Everything slower is left to the main loop
+
+    if (INT0IF) {
+        if (PORTBbits.RB0 == 0) {
+            HALT_ACTUATORS();
+            emergency_stop_pressed = true;
+            emergencyStopPending = true;
+        }
+        INT0IF = 0;
+    }
+}
+
+void __interrupt(low_priority) interruptHandler(void){
+// Handles interrupts received from RB1 (keypad), RB2 (RTC square wave), Timer2, the UART and I2C
 
     // Keypad interrupt
     if (INT1IE && INT1IF) {
-        // Set a flag to handle interrupt and clear interrupt flag bit
-        key = (PORTB & 0xF0);
-        key_was_pressed = true;
-        key = keys[key >> 4];
+        // Post the key pressed and clear interrupt flag bit
+        unsigned char pressedKey = keys[(PORTB & 0xF0) >> 4];
+        Event_Post(EV_KEY, pressedKey);
         INT1IF = 0;
+
+        // The tire count keys repeat while held so the count can be scrolled
+        if (CURRENT_SCREEN == SC_LOAD_TIRES && (pressedKey == '*' || pressedKey == '#')) {
+            heldKey = pressedKey;
+            heldKeyTime = KEY_REPEAT_DELAY_MS;
+        }
     }
-    
-    // Emergency stop interrupt
-    if (INT0IE && INT0IF) {
-        // Set a flag to customize the termination screen, clear interrupt flag bit
-        if (PORTBbits.RB0 == 0) {
-            emergency_stop_pressed = true;
-            activateEmergencyStop();
+
+    // UART receive interrupt (only enabled while waiting for a message from the Arduino)
+    if (RCIE && RCIF) {
+        if (Event_QueueFull()) {
+            // Leave the code in the UART until the main loop frees a slot, rather than losing it. The
+            // interrupt is masked meanwhile since RCIF stays set and would fire again straight away
+            uartReceiveDeferred = true;
+        } else {
+            // Post the message code, and leave the rest of the message to be read directly
+            Event_Post(EV_UART_RX, RCREG);
         }
-        INT0IF = 0;
+        RCIE = 0;
+    }
+    
+    // RTC square wave interrupt, once a second
+    if (INT2IE && INT2IF) {
+        RTC_ISR();
+    }
+
+    // I2C interrupt, advances the background transfer
+    if (SSPIE && SSPIF) {
+        I2C_ISR();
+    }
+
+    // I2C bus collision interrupt, drops the background transfer
+    if (BCLIE && BCLIF) {
+        I2C_CollisionISR();
+    }
+
+    // Timing probe cycle counter overflow
+    PROBE_ISR();
+
+    // Millisecond timebase interrupt
+    if (TMR2IE && TMR2IF) {
+        Timer_ISR();
+        repeatHeldKey();
+        Power_TickISR();
     }
 }
\ No newline at end of file
@@ -5,32 +5,148 @@
 
 /********************************* Includes **********************************/
 #include "operate.h"
+#include "probe.h"
 
 /******************************** Constants **********************************/
 
+/******************************** Variables **********************************/
+volatile bool actuatorsHalted = false;
+static long stepperPosition = 0;        // Absolute stepper position (steps forward of the magazine home)
+static unsigned char tiresLoaded = 0;   // Number of tires in the magazine when it was at home
+static long prepareTarget = 0;          // Position the pre-roll is heading to
+static bool preparing = false;          // A pre-roll is in progress
+
 /***************************** Private Functions *****************************/
+static void pulseStepper(long steps, unsigned char dir, bool fast) {
+    if (actuatorsHalted) {
+        return;
+    }
+    PROBE_BEGIN(PROBE_STEPPER);
 
-/***************************** Public Functions ******************************/
-void driveStepper(unsigned char revolutions, unsigned char dir) {
     // Enable stepper motor and set direction
     STEPPER_EN = 1;
     STEPPER_DIR = dir;
 
-    // Provide pulses to drive stepper
+    // Provide pulses to drive stepper, tracking the absolute position of each step
     STEPPER_PULSE = 0;
-    for (int i = 0; i < (CYCLES_FOR_ONE_REVOLUTION * revolutions); i++) { // 200 cycles is one revolution (360 degrees)
+    for (long i = 0; i < steps; i++) {
+        // Stop as soon as the emergency stop cuts the stepper
+        if (actuatorsHalted) {
+            break;
+        }
+
         STEPPER_PULSE = 1;
-        __delay_ms(1);
+        if (fast) {
+            __delay_us(STEPPER_HOME_HALF_PERIOD_US);
+        } else {
+            __delay_ms(STEPPER_HALF_PERIOD_MS);
+        }
         STEPPER_PULSE = 0;
-        __delay_ms(1);
+        if (fast) {
+            __delay_us(STEPPER_HOME_HALF_PERIOD_US);
+        } else {
+            __delay_ms(STEPPER_HALF_PERIOD_MS);
+        }
+
+        stepperPosition += (dir == FORWARD) ? 1 : -1;
     }
 
     // Disable stepper motor
     STEPPER_EN = 0;
     STEPPER_DIR = 0;
+
+    PROBE_END(PROBE_STEPPER);
+}
+
+/***************************** Public Functions ******************************/
+void driveStepper(unsigned char revolutions, unsigned char dir) {
+    // 200 cycles is one revolution (360 degrees)
+    pulseStepper((long)CYCLES_FOR_ONE_REVOLUTION * revolutions, dir, false);
+}
+
+void loadMagazine(unsigned char tires) {
+    // The magazine is loaded with the pusher at home. Retract it first in case an emergency stop left it
+    // out, the tracked position reaches 0 as it steps home
+    returnStepperHome();
+    tiresLoaded = tires;
+
+    // Any pre-roll left over from the last operation no longer applies
+    preparing = false;
+}
+
+unsigned char getTiresRemaining(void) {
+    // Every STEPS_PER_TIRE steps forward of home pushes one tire out of the magazine
+    if (stepperPosition <= 0) {
+        return tiresLoaded;
+    }
+
+    long tiresDropped = stepperPosition / STEPS_PER_TIRE;
+    if (tiresDropped >= tiresLoaded) {
+        return 0;
+    }
+
+    return tiresLoaded - (unsigned char)tiresDropped;
+}
+
+long getStepperPosition(void) {
+    return stepperPosition;
+}
+
+void returnStepperHome(void) {
+    // Retract the pusher back to home at the fast stepping rate
+    if (stepperPosition > 0) {
+        pulseStepper(stepperPosition, BACKWARD, true);
+    } else if (stepperPosition < 0) {
+        pulseStepper(-stepperPosition, FORWARD, true);
+    }
+}
+
+static long nextTireBoundary(void) {
+    // Position at which the tire currently being pushed has fallen off the magazine
+    long position = stepperPosition > 0 ? stepperPosition : 0;
+    return (position / STEPS_PER_TIRE + 1) * STEPS_PER_TIRE;
+}
+
+void prepareDeployment(void) {
+    // Push the next tire up to the point it would start to fall, so only the drop remains. The push is run
+    // in slices by continueDeployment so events keep being handled meanwhile
+    prepareTarget = nextTireBoundary() - (long)CYCLES_FOR_ONE_REVOLUTION * DROP_REVOLUTIONS;
+    preparing = prepareTarget > stepperPosition;
+}
+
+void continueDeployment(void) {
+    // Run the next slice of the pre-roll
+    if (!preparing) {
+        return;
+    }
+
+    long remaining = prepareTarget - stepperPosition;
+    if (remaining > PREPARE_STEPS_PER_SLICE) {
+        remaining = PREPARE_STEPS_PER_SLICE;
+    }
+    pulseStepper(remaining, FORWARD, false);
+
+    if (stepperPosition >= prepareTarget || actuatorsHalted) {
+        preparing = false;
+    }
+}
+
+void deployTire(void) {
+    // Finish pushing the next tire off the magazine, from wherever the pre-roll got to
+    preparing = false;
+    pulseStepper(nextTireBoundary() - stepperPosition, FORWARD, false);
+
+    // A pre-roll takes longer than the alignment at a pole, so start the next one while the robot drives on
+    if (getTiresRemaining() > 0) {
+        prepareDeployment();
+    }
 }
 
 void driveMotors(unsigned char state) {
+    if (actuatorsHalted) {
+        state = MOTOR_OFF;
+    }
+
     switch (state) {
         case MOTOR_OFF:
             MOTOR_BACK1 = 0;
@@ -57,4 +173,25 @@ void driveMotors(unsigned char state) {
             break;
 
     }
-}
\ No newline at end of file
+}
+
+void nudgeMotors(unsigned char state, unsigned char errorMM) {
+    // Drive the alignment motors for a pulse proportional to the alignment error
+    unsigned short pulseMS = (unsigned short)errorMM * ADJUST_MS_PER_MM;
+    if (pulseMS < ADJUST_MIN_PULSE_MS) {
+        pulseMS = ADJUST_MIN_PULSE_MS;
+    } else if (pulseMS > ADJUST_MAX_PULSE_MS) {
+        pulseMS = ADJUST_MAX_PULSE_MS;
+    }
+
+    driveMotors(state);
+    for (unsigned short i = 0; i < pulseMS && !actuatorsHalted; i++) {
+        __delay_ms(1);
+    }
+    driveMotors(MOTOR_OFF);
+}
+
+void releaseActuators(void) {
+    // Allow the actuators to be driven again after an emergency stop
+    actuatorsHalted = false;
+}
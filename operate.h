@@ -8,11 +8,19 @@
 
 /********************************* Includes **********************************/
 #include <xc.h>
+#include <stdbool.h>
 #include "configureBits.h"
 
 /********************************** Macros ***********************************/
 #define CYCLES_FOR_ONE_REVOLUTION 200 
 #define REVOLUTIONS_TO_DROP_ONE_TIRE 24
+#define STEPS_PER_TIRE ((long)CYCLES_FOR_ONE_REVOLUTION * REVOLUTIONS_TO_DROP_ONE_TIRE)
+#define DROP_REVOLUTIONS 4          // Final revolutions of each tire's push, during which the tire falls
+#define STEPPER_HALF_PERIOD_MS 1     // Half period of a deployment pulse (500 steps/s)
+#define PREPARE_SLICE_MS 90         // Stepping time of the pre-roll per EV_TICK, the rest of the tick is left for events
+#define PREPARE_STEPS_PER_SLICE (PREPARE_SLICE_MS / (2 * STEPPER_HALF_PERIOD_MS))
+
+#define STEPPER_HOME_HALF_PERIOD_US 250 // Half period of a pulse when returning home (4x deployment speed)
 
 // Stepper pin assignments
 #define STEPPER_EN LATEbits.LATE0
@@ -31,15 +39,50 @@
 #define MOTOR_OFF 0
 #define MOTOR_TOWARDS 1
 #define MOTOR_AWAY 2
+
+#define ADJUST_MS_PER_MM 4          // Alignment pulse length per millimetre of error
+#define ADJUST_MIN_PULSE_MS 15      // Shortest pulse, the fixed nudge known to move the robot
+#define ADJUST_MAX_PULSE_MS 150     // Longest single alignment pulse
+
+// Cuts power to the stepper and DC motors and keeps it cut until releaseActuators() is called. Only
+// writes latches, so it is safe to use from the high-priority interrupt
+#define HALT_ACTUATORS() {\
+    actuatorsHalted = true;\
+    STEPPER_EN = 0;\
+    MOTOR_BACK1 = 0;\
+    MOTOR_BACK2 = 0;\
+    MOTOR_FRONT1 = 0;\
+    MOTOR_FRONT2 = 0;\
+}
+
 /******************************** Constants **********************************/
 
 /********************************** Types ************************************/
 
 /******************************   Variables **********************************/
+extern volatile bool actuatorsHalted;   // Set by HALT_ACTUATORS(), blocks every actuator until released
 
 /************************ Public Function Prototypes *************************/
 void driveStepper(unsigned char revolutions, unsigned char dir);
 
+void loadMagazine(unsigned char tires);
+
+unsigned char getTiresRemaining(void);
+
+long getStepperPosition(void);
+
+void returnStepperHome(void);
+
+void prepareDeployment(void);
+
+void continueDeployment(void);
+
+void deployTire(void);
+
 void driveMotors(unsigned char state);
 
+void nudgeMotors(unsigned char state, unsigned char errorMM);
+
+void releaseActuators(void);
+
 #endif	/* OPERATE_H */
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * power.c
+ */
+
+#include "power.h"
+
+static volatile bool idling = false;            // The CPU is stopped in Idle mode
+static volatile unsigned long awakeTicks = 0;   // Milliseconds the CPU was running
+static volatile unsigned long idleTicks = 0;    // Milliseconds the CPU was idle
+
+// Stops the CPU until the next interrupt. In Idle mode the peripherals keep their clock, so Timer2,
+// the UART and the MSSP keep running and any of their interrupts, a key press or the RTC tick wakes it
+void Power_Idle(void) {
+    OSCCONbits.IDLEN = 1;
+    idling = true;
+    SLEEP();
+    NOP();
+    idling = false;
+}
+
+// Called from the millisecond timebase interrupt, samples whether the CPU was idle
+void Power_TickISR(void) {
+    if (idling) {
+        idleTicks++;
+    } else {
+        awakeTicks++;
+    }
+}
+
+// Share of the time (%) the CPU has been running since the statistics were reset
+unsigned char Power_AwakePercent(void) {
+    // Copy with the Timer2 interrupt masked so the counts are not torn
+    TMR2IE = 0;
+    unsigned long awake = awakeTicks;
+    unsigned long total = awakeTicks + idleTicks;
+    TMR2IE = 1;
+
+    if (total == 0) {
+        return 100;
+    }
+
+    // Halve both counts until the awake count can be multiplied by 100 without overflowing (after
+    // about 12 hours), which keeps the ratio
+    while (total > 0xFFFFFFFF / 100) {
+        awake >>= 1;
+        total >>= 1;
+    }
+    return (unsigned char)((awake * 100) / total);
+}
+
+void Power_ResetStats(void) {
+    TMR2IE = 0;
+    awakeTicks = 0;
+    idleTicks = 0;
+    TMR2IE = 1;
+}
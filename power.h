@@ -0,0 +1,18 @@
+/**
+ * power.h
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+/********************************* Includes **********************************/
+#include <xc.h>
+#include <stdbool.h>
+#include "configureBits.h"
+
+/************************ Public Function Prototypes *************************/
+void Power_Idle(void);
+void Power_TickISR(void);
+unsigned char Power_AwakePercent(void);
+void Power_ResetStats(void);
+#endif /* POWER_H */
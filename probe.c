@@ -0,0 +1,134 @@
+/**
+ * probe.c
+ */
+
+#include "probe.h"
+
+#ifdef PROBES_ENABLED
+#include <stdio.h>
+#include "timer.h"
+#include "uart.h"
+
+static const char * probeNames[PROBE_COUNT] = {
+    "STORE_LOG",
+    "DISP_PAGE",
+    "RENDER_OP",
+    "STEPPER",
+    "SCR_EVENT",
+    "EVT_WAIT"
+};
+
+static ProbeStats probeStats[PROBE_COUNT];
+static unsigned long probeStart[PROBE_COUNT];   // Time each running probe began
+static volatile unsigned short timerOverflows = 0;  // Upper 16 bits of the Timer1 count
+
+/***************************** Private Functions *****************************/
+// Reads the 32 bit cycle count, Timer1 in the lower 16 bits and its overflows in the upper 16
+static unsigned long probeNow(void) {
+    unsigned short high;
+    unsigned char low;
+
+    // Read again if Timer1 overflowed while it was read
+    do {
+        high = timerOverflows;
+        low = TMR1L;    // Latches TMR1H in 16 bit read mode
+    } while (high != timerOverflows);
+
+    return ((unsigned long)high << 16) | ((unsigned short)TMR1H << 8) | low;
+}
+
+// Adds a measurement (Timer1 ticks) to a probe's statistics
+static void probeRecord(ProbeId id, unsigned long elapsed) {
+    ProbeStats *stats = &probeStats[id];
+
+    stats->count++;
+
+    // Sum in microseconds, carrying the part below a microsecond over to the next measurement
+    unsigned long ticks = elapsed + stats->leftover;
+    stats->total += ticks / PROBE_TICKS_PER_US;
+    stats->leftover = (unsigned char)(ticks % PROBE_TICKS_PER_US);
+
+    if (elapsed < stats->min) {
+        stats->min = elapsed;
+    }
+    if (elapsed > stats->max) {
+        stats->max = elapsed;
+    }
+}
+
+/***************************** Public Functions ******************************/
+void Probe_Init(void) {
+    // Timer1 free runs on the instruction clock, read as 16 bits at once
+    T1CONbits.RD16 = 1;
+    T1CONbits.T1CKPS = 0b00;
+    T1CONbits.TMR1CS = 0;
+    TMR1H = 0;
+    TMR1L = 0;
+
+    // Count the overflows in a low-priority interrupt
+    TMR1IF = 0;
+    TMR1IP = 0;
+    TMR1IE = 1;
+    TMR1ON = 1;
+
+    Probe_Reset();
+}
+
+// Called from the interrupt handler each time Timer1 overflows (every 6.5 ms)
+void Probe_TimerISR(void) {
+    timerOverflows++;
+    TMR1IF = 0;
+}
+
+void Probe_Begin(ProbeId id) {
+    probeStart[id] = probeNow();
+}
+
+void Probe_End(ProbeId id) {
+    probeRecord(id, probeNow() - probeStart[id]);
+}
+
+// Records how long an event waited in the queue, from the time stamped on it when it was posted
+void Probe_Event(const Event *event) {
+    probeRecord(PROBE_EVENT_WAIT, (Timer_Millis() - event->time) * 1000UL * PROBE_TICKS_PER_US);
+}
+
+// Streams the table over the UART as text, one line per probe, with every time in microseconds. The
+// message code in front tells the Arduino to skip the text up to the terminating 0
+unsigned char Probe_Dump(unsigned char messageCode) {
+    char line[64];
+
+    if (UART_Write(messageCode) == UART_WRITE_TIMEOUT) {
+        return UART_WRITE_TIMEOUT;
+    }
+
+    sprintf(line, "\r\n%-9s %9s %9s %9s %9s\r\n", "PROBE", "COUNT", "MIN_US", "MAX_US", "TOTAL_US");
+    if (UART_Write_Text((unsigned char *)line) == UART_WRITE_TIMEOUT) {
+        return UART_WRITE_TIMEOUT;
+    }
+
+    for (unsigned char i = 0; i < PROBE_COUNT; i++) {
+        ProbeStats *stats = &probeStats[i];
+        sprintf(line, "%-9s %9lu %9lu %9lu %9lu\r\n", probeNames[i], stats->count,
+                stats->count ? stats->min / PROBE_TICKS_PER_US : 0,
+                stats->max / PROBE_TICKS_PER_US,
+                stats->total);
+
+        if (UART_Write_Text((unsigned char *)line) == UART_WRITE_TIMEOUT) {
+            return UART_WRITE_TIMEOUT;
+        }
+    }
+
+    return UART_Write('\0');
+}
+
+void Probe_Reset(void) {
+    for (unsigned char i = 0; i < PROBE_COUNT; i++) {
+        probeStats[i].count = 0;
+        probeStats[i].min = 0xFFFFFFFF;
+        probeStats[i].max = 0;
+        probeStats[i].total = 0;
+        probeStats[i].leftover = 0;
+    }
+}
+#endif
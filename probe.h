@@ -0,0 +1,66 @@
+/**
+ * probe.h
+ */
+
+#ifndef PROBE_H
+#define PROBE_H
+
+/********************************* Includes **********************************/
+#include <xc.h>
+#include "configureBits.h"
+#include "events.h"
+
+/********************************** Macros ***********************************/
+// Timing probes are only built in when PROBES_ENABLED is defined (add it to the compiler's preprocessor
+// macros, -DPROBES_ENABLED). Otherwise every macro below compiles to nothing
+#ifdef PROBES_ENABLED
+#define PROBE_INIT() Probe_Init()
+#define PROBE_BEGIN(id) Probe_Begin(id)
+#define PROBE_END(id) Probe_End(id)
+#define PROBE_EVENT(event) Probe_Event(event)
+#define PROBE_ISR() {\
+    if (TMR1IE && TMR1IF) {\
+        Probe_TimerISR();\
+    }\
+}
+#else
+#define PROBE_INIT()
+#define PROBE_BEGIN(id)
+#define PROBE_END(id)
+#define PROBE_EVENT(event)
+#define PROBE_ISR()
+#endif
+
+// Timer1 counts instruction cycles: 40 MHz / 4 = 10 MHz, one tick every 0.1 us
+#define PROBE_TICKS_PER_US 10
+
+/********************************** Types ************************************/
+typedef enum {
+    PROBE_STORE_LOG = 0,    // storeOperationIntoLogs
+    PROBE_DISPLAY_PAGE,     // displayPage
+    PROBE_RENDER_OPERATING, // Drawing the operating screen (setScreen(SC_OPERATING) and its refreshes)
+    PROBE_STEPPER,          // Every stepper move (driveStepper, prepareDeployment, deployTire, ...)
+    PROBE_SCREEN_EVENT,     // Screen event handlers (the Arduino message handler while operating)
+    PROBE_EVENT_WAIT,       // Time events wait in the queue before the main loop takes them (1 ms resolution)
+    PROBE_COUNT
+} ProbeId;
+
+typedef struct ProbeStats {
+    unsigned long count;    // Number of completed measurements
+    unsigned long min;      // Shortest measurement (Timer1 ticks)
+    unsigned long max;      // Longest measurement (Timer1 ticks)
+    unsigned long total;    // Sum of every measurement (us, so it lasts 71 minutes rather than 7)
+    unsigned char leftover; // Timer1 ticks not yet worth a whole microsecond of the total
+} ProbeStats;
+
+/************************ Public Function Prototypes *************************/
+#ifdef PROBES_ENABLED
+void Probe_Init(void);
+void Probe_TimerISR(void);
+void Probe_Begin(ProbeId id);
+void Probe_End(ProbeId id);
+void Probe_Event(const Event *event);
+unsigned char Probe_Dump(unsigned char messageCode);
+void Probe_Reset(void);
+#endif
+#endif /* PROBE_H */
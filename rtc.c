@@ -0,0 +1,147 @@
+/**
+ * rtc.c
+ */
+
+#include "rtc.h"
+
+// The time is kept in RAM in the RTC's own BCD register layout (seconds, minutes, hours, weekday, day,
+// month, year) and advanced by the 1 Hz square wave, so reading it costs no I2C traffic
+static volatile unsigned char cachedTime[7];
+static unsigned char resyncTime[7];                 // Buffer for the background re-read of the RTC
+static volatile unsigned short secondsSinceSync = 0;
+static volatile bool resyncDue = false;             // Set at midnight and every RTC_RESYNC_SECONDS
+static bool resyncPending = false;                  // A background re-read is on the I2C queue
+static SoftTimer resyncTimer;                       // Gives up on a re-read whose callback never ran
+
+/***************************** Private Functions *****************************/
+// Adds one to a BCD value, wrapping to 0 past the limit (in BCD). Returns true when it wraps
+static bool incrementBCD(volatile unsigned char *value, unsigned char limit) {
+    if (*value >= limit) {
+        *value = 0;
+        return true;
+    }
+
+    (*value)++;
+    if ((*value & 0x0F) > 9) {
+        *value = (*value & 0xF0) + 0x10;
+    }
+    return false;
+}
+
+static void copyTime(const unsigned char source[], volatile unsigned char destination[]) {
+    destination[0] = source[0] & 0x7F;  // Clear the clock halt bit
+    destination[1] = source[1];
+    destination[2] = source[2] & 0x3F;  // The RTC is kept in 24 hour mode
+    destination[3] = source[3];
+    destination[4] = source[4];
+    destination[5] = source[5];
+    destination[6] = source[6];
+}
+
+static void resyncRead(I2CTransfer *transfer) {
+    resyncPending = false;
+    SoftTimer_Stop(&resyncTimer);
+    if (transfer->result != SUCCESSFUL) {
+        return;
+    }
+
+    // Replace the cached time with the time read, between two square wave edges
+    INT2IE = 0;
+    copyTime(transfer->buffer, cachedTime);
+    secondsSinceSync = 0;
+    resyncDue = false;
+    INT2IE = 1;
+}
+
+/***************************** Public Functions ******************************/
+void RTC_Init(void) {
+    unsigned char time[7];
+
+    // Output a 1 Hz square wave on SQW/OUT, the seconds tick over on its falling edge
+    I2C_Master_Start();
+    I2C_Master_Write(RTC_ADDRESS << 1);     // 7 bit RTC address + Write
+    I2C_Master_Write(RTC_CONTROL_REGISTER);
+    I2C_Master_Write(RTC_SQW_1HZ);
+    I2C_Master_Stop();
+
+    // Start from the current time
+    readTime(time);
+    copyTime(time, cachedTime);
+
+    // SQW/OUT is open drain and is wired to RB2 (INT2), which needs an external pull-up. The PORTB
+    // pull-ups are left off since they would also pull up the keypad inputs on RB0, RB1 and RB4-RB7
+    TRISBbits.TRISB2 = 1;
+
+    // Interrupt on the falling edge, at low priority
+    INTCON2bits.INTEDG2 = 0;
+    INT2IF = 0;
+    INT2IP = 0;
+    INT2IE = 1;
+}
+
+// Called from the interrupt handler once every second
+void RTC_ISR(void) {
+    INT2IF = 0;
+
+    // Carry the second through the minutes and hours
+    if (incrementBCD(&cachedTime[0], 0x59) && incrementBCD(&cachedTime[1], 0x59)
+            && incrementBCD(&cachedTime[2], 0x23)) {
+        // The date changed, read it back rather than working out the calendar here
+        resyncDue = true;
+    }
+
+    secondsSinceSync++;
+    if (secondsSinceSync >= RTC_RESYNC_SECONDS) {
+        resyncDue = true;
+    }
+
+    Event_Post(EV_RTC_SECOND, 0);
+}
+
+// Called from the main loop, re-reads the RTC in the background when it is due
+void RTC_Update(void) {
+    // Retry a re-read that never completed rather than waiting on it forever
+    if (resyncPending && SoftTimer_Expired(&resyncTimer)) {
+        SoftTimer_Stop(&resyncTimer);
+        resyncPending = false;
+    }
+
+    if (resyncDue && !resyncPending) {
+        resyncPending = readTimeAsync(resyncTime, resyncRead) == SUCCESSFUL;
+        if (resyncPending) {
+            SoftTimer_Start(&resyncTimer, RTC_RESYNC_TIMEOUT_MS);
+        }
+    }
+}
+
+void RTC_GetTime(unsigned char pTime[]) {
+    // Copy with the square wave interrupt masked so the time is not torn
+    INT2IE = 0;
+    for (unsigned char i = 0; i < 7; i++) {
+        pTime[i] = cachedTime[i];
+    }
+    INT2IE = 1;
+}
+
+void RTC_GetCondensedTime(unsigned char pTime[]) {
+    // Excludes year and weekday: seconds, minutes, hours, day of month, month
+    unsigned char time[7];
+    RTC_GetTime(time);
+
+    for (unsigned char i = 0; i < 3; i++) {
+        pTime[i] = time[i];
+    }
+
+    pTime[3] = time[4];
+    pTime[4] = time[5];
+}
+
+void RTC_SetTime(char timeToInitialize[]) {
+    // Write the RTC and the cache together
+    rtcSetTime(timeToInitialize);
+
+    INT2IE = 0;
+    copyTime((unsigned char *)timeToInitialize, cachedTime);
+    secondsSinceSync = 0;
+    INT2IE = 1;
+}
@@ -0,0 +1,31 @@
+/**
+ * rtc.h
+ */
+
+#ifndef RTC_H
+#define RTC_H
+
+/********************************* Includes **********************************/
+#include <xc.h>
+#include <stdbool.h>
+#include "configureBits.h"
+#include "I2C.h"
+#include "events.h"
+#include "timer.h"
+
+/********************************** Macros ***********************************/
+#define RTC_CONTROL_REGISTER 0x07
+#define RTC_SQW_1HZ 0b00010000      // SQWE set with RS1:RS0 = 00, a 1 Hz square wave on SQW/OUT
+
+#define RTC_RESYNC_SECONDS 3600     // Time between re-reads of the RTC over I2C
+#define RTC_RESYNC_TIMEOUT_MS 1000  // Time after which a re-read that never completed is submitted again
+
+/************************ Public Function Prototypes *************************/
+void RTC_Init(void);
+void RTC_ISR(void);
+void RTC_Update(void);
+
+void RTC_GetTime(unsigned char pTime[]);
+void RTC_GetCondensedTime(unsigned char pTime[]);
+void RTC_SetTime(char timeToInitialize[]);
+#endif /* RTC_H */
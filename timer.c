@@ -0,0 +1,82 @@
+/**
+ * timer.c
+ */
+
+#include "timer.h"
+
+static volatile unsigned long msTicks = 0;  // Milliseconds since Timer_Init
+static unsigned char tickEventCounter = 0;  // Milliseconds since the last EV_TICK
+
+void Timer_Init(void) {
+    // Timer2 is used since its period register gives an exact 1 ms tick without reloading
+    TMR2 = 0;
+    PR2 = TIMER_PR2_1MS;
+    T2CONbits.T2CKPS = TIMER_PRESCALE_1_4;
+    T2CONbits.T2OUTPS = TIMER_POSTSCALE_1_10;
+
+    // Enable the Timer2 interrupt (a low-priority peripheral interrupt) and start the timer
+    TMR2IF = 0;
+    TMR2IP = 0;
+    TMR2IE = 1;
+    PEIE = 1;
+    TMR2ON = 1;
+}
+
+// Called from the interrupt handler on every Timer2 match
+void Timer_ISR(void) {
+    msTicks++;
+
+    // Post a tick for the screens that refresh periodically
+    tickEventCounter++;
+    if (tickEventCounter == TICK_EVENT_MS) {
+        tickEventCounter = 0;
+        Event_Post(EV_TICK, 0);
+    }
+
+    TMR2IF = 0;
+}
+
+unsigned long Timer_Millis(void) {
+    // The counter is updated by the interrupt, so copy it with the interrupt masked
+    TMR2IE = 0;
+    unsigned long ticks = msTicks;
+    TMR2IE = 1;
+
+    return ticks;
+}
+
+// Same as Timer_Millis, for use inside the interrupt handler where the counter cannot change
+unsigned long Timer_MillisISR(void) {
+    return msTicks;
+}
+
+void SoftTimer_Start(SoftTimer *timer, unsigned long periodMS) {
+    timer->start = Timer_Millis();
+    timer->period = periodMS;
+    timer->running = true;
+}
+
+// Same as SoftTimer_Start, for use inside the interrupt handler (Timer_Millis would re-enable the tick there)
+void SoftTimer_StartISR(SoftTimer *timer, unsigned long periodMS) {
+    timer->start = Timer_MillisISR();
+    timer->period = periodMS;
+    timer->running = true;
+}
+
+void SoftTimer_Stop(SoftTimer *timer) {
+    timer->running = false;
+}
+
+// Returns true once per period; the next period starts where the last one ended so no time drifts
+bool SoftTimer_Expired(SoftTimer *timer) {
+    if (!timer->running || Timer_Millis() - timer->start < timer->period) {
+        return false;
+    }
+
+    timer->start += timer->period;
+    return true;
+}
+
+unsigned long SoftTimer_Elapsed(SoftTimer *timer) {
+    return Timer_Millis() - timer->start;
+}
@@ -0,0 +1,40 @@
+/**
+ * timer.h
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/********************************* Includes **********************************/
+#include <xc.h>
+#include <stdbool.h>
+#include "configureBits.h"
+#include "events.h"
+
+/********************************** Macros ***********************************/
+// Timer2 overflows every 1 ms: 40 MHz / 4 / 4 (prescale) / 250 (PR2 + 1) / 10 (postscale) = 1 kHz
+#define TIMER_PR2_1MS 249
+#define TIMER_PRESCALE_1_4 0b01
+#define TIMER_POSTSCALE_1_10 0b1001
+
+#define TICK_EVENT_MS 100   // Period of the EV_TICK event
+
+/********************************** Types ************************************/
+typedef struct SoftTimer {
+    unsigned long start;     // Time (ms) the current period started
+    unsigned long period;    // Length (ms) of a period
+    bool running;
+} SoftTimer;
+
+/************************ Public Function Prototypes *************************/
+void Timer_Init(void);
+void Timer_ISR(void);
+unsigned long Timer_Millis(void);
+unsigned long Timer_MillisISR(void);
+
+void SoftTimer_Start(SoftTimer *timer, unsigned long periodMS);
+void SoftTimer_StartISR(SoftTimer *timer, unsigned long periodMS);
+void SoftTimer_Stop(SoftTimer *timer);
+bool SoftTimer_Expired(SoftTimer *timer);
+unsigned long SoftTimer_Elapsed(SoftTimer *timer);
+#endif /* TIMER_H */
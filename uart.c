@@ -66,6 +66,15 @@ char UART_Data_Ready(void) {
     return RCIF;
 }
 
+// Enables the receive interrupt, first clearing an overrun that stops the UART receiving
+void UART_Listen(void) {
+    if (OERR) {
+        CREN = 0;
+        CREN = 1;
+    }
+    RCIE = 1;
+}
+
 // Read and return the data in the register
 unsigned char UART_Read(unsigned char *requestedData) {
     unsigned short timeoutCounter = 0;
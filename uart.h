@@ -27,7 +27,7 @@
     if (UART_Result == UART_READ_TIMEOUT) {\
         setStatus(ST_ERROR);\
         setScreen(SC_UART_READ_TIMEOUT_ERROR);\
-        break;\
+        return;\
     }\
 }
 
@@ -45,7 +45,7 @@
     if (UART_Result == UART_READ_TIMEOUT) {\
         setStatus(ST_ERROR);\
         setScreen(SC_UART_READ_TIMEOUT_ERROR);\
-        break;\
+        return;\
     } else if (UART_Result == UART_WRITE_TIMEOUT) {\
         setStatus(ST_ERROR);\
         setScreen(SC_SEND_ARDUINO_MESSAGE_ERROR);\
@@ -63,7 +63,7 @@
                     "UART read timed ",             \
                     "      out       ",             \
                     "[D] OK          ");            \
-        break;                                      \
+        return;                                     \
     } else if (UART_Result == UART_WRITE_TIMEOUT) { \
         CURRENT_STATUS = ST_ERROR;                  \
         CURRENT_SCREEN = SC_SEND_ARDUINO_MESSAGE_ERROR;\
@@ -73,7 +73,7 @@
                         "[D] OK          ");        \
         lcd_set_ddram_addr(LCD_LINE3_ADDR);         \
         printf(errorMsg);                           \
-        break;                                      \
+        return;                                     \
     }                                               \
 }
 
@@ -83,6 +83,7 @@ unsigned char UART_Write(unsigned char data);
 unsigned char UART_Write_Text(unsigned char *text);
 
 char UART_Data_Ready(void);
+void UART_Listen(void);
 unsigned char UART_Read(unsigned char *requestedData);
 unsigned char UART_Read_Text(unsigned char *output, unsigned int length);
 unsigned char UART_Read_Short(unsigned short *requestedData);